@@ -0,0 +1,754 @@
+// Host microbenchmarks of the RTCM hot path: the byte ingest of MyGPS (RTCMParser and
+//  RTCMEpochBuffer), the store of the epochs in the frame pool (RTCMFramePool), the
+//  chunks and packets of MyCom (RTCMEpochChunker, writeChunkPacket), the epoch tags (ChaskeyMac) and the
+//  reassembly on the rovers (RTCMReassembler), which also checks that the rovers get the
+//  frames back unchanged, with and without the markers of the static frames (RTCMStaticCache).
+//
+//   pio run -e bench -t bench
+//   .pio/build/bench/program [--capture file.rtcm] [--json results.json] [--log-dir directory]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ChaskeyMac.hpp>
+#include <DroidProtocol.hpp>
+#include <RTCMEpochChunker.hpp>
+#include <RTCMReassembler.hpp>
+#include <RTCMStaticCache.hpp>
+#include "../src/HostLogStorage.hpp"
+#include "../src/RTCMEpochBuffer.hpp"
+#include "../src/RTCMFramePool.hpp"
+#include "../src/RTCMLogWriter.hpp"
+#include "../src/RTCMParser.hpp"
+
+using namespace lacar::droid_basestation;
+using namespace lacar::droid_basestation::firmware;
+
+namespace
+{
+    /// @brief The chunk size of the firmware (GPS__RTCM_BUFFER_SIZE).
+    constexpr uint8_t ChunkSize = 32U;
+
+    /// @brief The epoch buffer size of the firmware (GPS__EPOCH_BUFFER_SIZE).
+    constexpr uint16_t EpochBufferSize = 768U;
+
+    /// @brief The interval at which the static frames are sent in full (COM__STATIC_REFRESH_INTERVAL).
+    constexpr uint32_t StaticRefreshMillis = 30000U;
+
+    /// @brief The number of epochs of the synthesized capture.
+    constexpr int SynthesizedEpochs = 100;
+
+    /// @brief The key of the epoch tags.
+    const uint32_t AuthKey[4] = {0x5F3C2A91UL, 0xB4E8D706UL, 0x19A7C35EUL, 0x7D06F2B8UL};
+
+    /// @brief The minimum time every benchmark runs for.
+    constexpr double MinRunSeconds = 0.2;
+
+    /// @brief The number of runs, of which the fastest is reported.
+    constexpr int Runs = 5;
+
+    struct Result
+    {
+        std::string name;
+        double nsPerByte;
+        double nsPerPacket;
+        double packetsPerSecond;
+    };
+
+    /// @brief Appends bits to a big-endian bit stream.
+    void putBits(std::vector<uint8_t> &data, size_t &bit, uint32_t value, int count)
+    {
+        for (int i = count - 1; i >= 0; --i, ++bit)
+        {
+            if (data.size() * 8U <= bit)
+                data.push_back(0U);
+            if ((value >> i) & 1U)
+                data[bit / 8U] |= static_cast<uint8_t>(0x80U >> (bit % 8U));
+        }
+    }
+
+    /// @brief Appends an RTCM frame with the given message and payload size, with a valid CRC.
+    void putFrame(std::vector<uint8_t> &stream, uint16_t messageNumber, uint32_t epochTime,
+                  bool multipleMessage, uint16_t payloadSize, uint32_t &seed)
+    {
+        std::vector<uint8_t> payload;
+        size_t bit = 0U;
+
+        putBits(payload, bit, messageNumber, 12);
+        putBits(payload, bit, 0U, 12);
+        if (RTCMParser::isMSM(messageNumber))
+        {
+            putBits(payload, bit, epochTime, 30);
+            putBits(payload, bit, multipleMessage ? 1U : 0U, 1);
+        }
+
+        // Fills the rest with pseudo random observations.
+        while (payload.size() < payloadSize)
+        {
+            seed = seed * 1664525U + 1013904223U;
+            payload.push_back(static_cast<uint8_t>(seed >> 24));
+        }
+
+        const size_t start = stream.size();
+        stream.push_back(RTCMParser::Preamble);
+        stream.push_back(static_cast<uint8_t>(payload.size() >> 8));
+        stream.push_back(static_cast<uint8_t>(payload.size()));
+        stream.insert(stream.end(), payload.begin(), payload.end());
+
+        uint32_t crc = 0U;
+        for (size_t i = start; i < stream.size(); ++i)
+            crc = RTCMParser::updateCrc(crc, stream[i]);
+
+        stream.push_back(static_cast<uint8_t>(crc >> 16));
+        stream.push_back(static_cast<uint8_t>(crc >> 8));
+        stream.push_back(static_cast<uint8_t>(crc));
+    }
+
+    /// @brief Gets the GLONASS epoch time of the given GPS time of week: the day of week
+    ///  and the time of day in Moscow time (UTC + 3 h), with 18 leap seconds.
+    uint32_t getGlonassEpochTime(uint32_t gpsTimeOfWeek)
+    {
+        const uint32_t moscowTime = (gpsTimeOfWeek + 3U * 3600000U - 18000U) % (7U * 86400000U);
+
+        return ((moscowTime / 86400000U) << 27) | (moscowTime % 86400000U);
+    }
+
+    /// @brief Synthesizes a capture of the messages the base station is configured for: 1005
+    ///  every epoch, 1077 and 1087 MSM7 with typical satellite counts, 1230 every tenth epoch.
+    ///  The 1005 and 1230 frames are the same every time, as they are on a surveyed station.
+    std::vector<uint8_t> synthesizeCapture(int epochs)
+    {
+        std::vector<uint8_t> stream;
+        uint32_t seed = 1U;
+
+        for (int epoch = 0; epoch < epochs; ++epoch)
+        {
+            // Starts on a Thursday at noon GPS time.
+            const uint32_t epochTime = 4U * 86400000U + 12U * 3600000U + static_cast<uint32_t>(epoch) * 1000U;
+
+            uint32_t stationSeed = 1U;
+            uint32_t biasSeed = 2U;
+
+            putFrame(stream, 1005U, 0U, false, 19U, stationSeed);
+            putFrame(stream, 1077U, epochTime, true, 310U + (seed % 40U), seed);
+            putFrame(stream, 1087U, getGlonassEpochTime(epochTime), false, 230U + (seed % 30U), seed);
+            if (epoch % 10 == 0)
+                putFrame(stream, 1230U, 0U, false, 8U, biasSeed);
+        }
+
+        return stream;
+    }
+
+    /// @brief Reads a raw RTCM capture from a file.
+    bool readCapture(const char *path, std::vector<uint8_t> &stream)
+    {
+        FILE *file = std::fopen(path, "rb");
+        if (file == nullptr)
+            return false;
+
+        uint8_t buffer[4096];
+        size_t read;
+        while ((read = std::fread(buffer, 1U, sizeof(buffer), file)) > 0U)
+            stream.insert(stream.end(), buffer, buffer + read);
+
+        std::fclose(file);
+        return true;
+    }
+
+    /// @brief Runs the given body until the minimum time has elapsed, and returns the
+    ///  fastest time per iteration over all runs.
+    template <typename Body>
+    double measure(Body body)
+    {
+        double best = 0.0;
+
+        for (int run = 0; run < Runs; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            double elapsed = 0.0;
+            long iterations = 0;
+
+            do
+            {
+                body();
+                ++iterations;
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            } while (elapsed < MinRunSeconds);
+
+            const double perIteration = elapsed / static_cast<double>(iterations);
+            if (run == 0 || perIteration < best)
+                best = perIteration;
+        }
+
+        return best;
+    }
+
+    /// @brief Keeps the optimizer from removing the measured work.
+    volatile uint32_t g_Sink;
+
+    struct BurstCounter
+    {
+        uint8_t packet[sizeof(protocol::RTCMStreamChunkHeader) + ChunkSize];
+        uint32_t epochs;
+        uint32_t packets;
+        uint16_t sequence;
+        bool buildPackets;
+    };
+
+    void flushEpoch(void *u, const uint8_t *epoch, uint16_t epochSize)
+    {
+        BurstCounter &counter = *static_cast<BurstCounter *>(u);
+        ++counter.epochs;
+
+        // Splits the epoch into chunks, as MyCom::writeRTCMEpoch does.
+        protocol::RTCMEpochChunker chunker(epoch, epochSize, ChunkSize, 0U, nullptr, 0U);
+        protocol::RTCMEpochChunker::Chunk chunk;
+
+        while (chunker.next(chunk))
+        {
+            if (counter.buildPackets)
+                g_Sink += protocol::writeChunkPacket(counter.packet, 0U, counter.sequence++, chunk.flags, chunk.data, chunk.size);
+
+            ++counter.packets;
+        }
+    }
+
+    bool mayFlushEpoch(void *u)
+    {
+        (void)u;
+        return true;
+    }
+
+    struct PacketCollector
+    {
+        std::vector<std::vector<uint8_t>> packets;
+        const protocol::ChaskeyMac::Key *key;
+        protocol::RTCMStaticCache *staticCache;
+        protocol::ChaskeyMac mac;
+        uint32_t millis;
+        uint16_t sequence;
+    };
+
+    /// @brief Splits the epoch into chunks with the chunker of MyCom::writeRTCMEpoch, and adds
+    ///  them to the packets and to the tag of the epoch.
+    void collectEpoch(void *u, const uint8_t *epoch, uint16_t epochSize)
+    {
+        PacketCollector &collector = *static_cast<PacketCollector *>(u);
+        const uint8_t tagSize = collector.key != nullptr ? protocol::EpochTagSize : 0U;
+
+        if (collector.key != nullptr)
+            protocol::beginEpochTag(collector.mac, *collector.key, 0U, collector.sequence);
+
+        // The epochs are a second apart.
+        collector.millis += 1000U;
+
+        protocol::RTCMEpochChunker chunker(epoch, epochSize, ChunkSize, tagSize, collector.staticCache, collector.millis);
+        protocol::RTCMEpochChunker::Chunk chunk;
+
+        while (chunker.next(chunk))
+        {
+            const bool last = (chunk.flags & protocol::ChunkFlagEpochEnd) != 0U;
+            const uint8_t packetTagSize = last ? tagSize : 0U;
+
+            std::vector<uint8_t> packet(sizeof(protocol::RTCMStreamChunkHeader) + chunk.size + packetTagSize);
+            protocol::writeChunkPacket(packet.data(), 0U, collector.sequence++, chunk.flags, chunk.data, chunk.size);
+
+            if (collector.key != nullptr)
+            {
+                collector.mac.update(chunk.data, chunk.size);
+                if (last)
+                    collector.mac.finish(&packet[packet.size() - packetTagSize], packetTagSize);
+            }
+
+            collector.packets.push_back(packet);
+        }
+    }
+
+    /// @brief Collects the packets of the given capture.
+    void collect(const std::vector<uint8_t> &capture, PacketCollector &collector)
+    {
+        uint8_t storage[EpochBufferSize];
+        RTCMEpochBuffer buffer(storage, sizeof(storage), collectEpoch, mayFlushEpoch, &collector);
+
+        for (uint8_t byte : capture)
+            buffer.push(byte);
+    }
+
+    void collectFrame(void *u, const uint8_t *frame, uint16_t frameSize)
+    {
+        std::vector<uint8_t> &frames = *static_cast<std::vector<uint8_t> *>(u);
+
+        frames.insert(frames.end(), frame, frame + frameSize);
+    }
+
+    void countFrame(void *u, const uint8_t *frame, uint16_t frameSize)
+    {
+        (void)u;
+        (void)frame;
+
+        g_Sink += frameSize;
+    }
+
+    /// @brief Reassembles the given packets on the rover side, skipping every dropInterval-th
+    ///  packet if it is not zero, and flipping a bit in every tamperInterval-th packet if it
+    ///  is not zero.
+    void reassemble(rover::RTCMReassembler &reassembler, const PacketCollector &collector, uint32_t dropInterval,
+                    uint32_t tamperInterval = 0U)
+    {
+        for (size_t i = 0U; i < collector.packets.size(); ++i)
+        {
+            if (dropInterval != 0U && i % dropInterval == dropInterval - 1U)
+                continue;
+
+            std::vector<uint8_t> packet = collector.packets[i];
+            if (tamperInterval != 0U && i % tamperInterval == tamperInterval - 1U)
+                packet.back() ^= 0x01U;
+
+            protocol::RTCMStreamChunkHeader header;
+            const uint8_t *chunk;
+            uint8_t chunkSize;
+
+            if (protocol::readChunkPacket(packet.data(), static_cast<uint8_t>(packet.size()), header, chunk, chunkSize))
+                reassembler.push(header, chunk, chunkSize, 0U);
+        }
+    }
+
+    /// @brief Checks that the rovers get exactly the frames of the base station, and only
+    ///  complete frames when packets are lost.
+    bool checkReassembly(const std::vector<uint8_t> &capture, const PacketCollector &collector,
+                         const PacketCollector &authenticatedCollector, const protocol::ChaskeyMac::Key &key)
+    {
+        std::vector<uint8_t> frames;
+        uint8_t storage[rover::RTCMReassembler::MaxFrameSize];
+
+        {
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), collectFrame, 1000U, &frames);
+            reassemble(reassembler, collector, 0U);
+
+            // The epoch buffer holds back the last epoch until the next one starts.
+            if (frames.empty() || frames.size() > capture.size() || !std::equal(frames.begin(), frames.end(), capture.begin()) ||
+                reassembler.getStatistics().lostChunks != 0U || reassembler.getStatistics().invalidFrames != 0U)
+            {
+                std::fprintf(stderr, "The reassembled frames differ from the capture\n");
+                return false;
+            }
+        }
+
+        frames.clear();
+
+        {
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), collectFrame, 1000U, &frames);
+            reassemble(reassembler, collector, 7U);
+
+            // Every frame that makes it through must be a frame of the capture.
+            RTCMParser parser;
+            uint32_t parsed = 0U;
+            for (uint8_t byte : frames)
+                parsed += parser.push(byte) == RTCMParser::Result::Frame;
+
+            if (parsed != reassembler.getStatistics().frames || reassembler.getStatistics().lostChunks == 0U)
+            {
+                std::fprintf(stderr, "The reassembly passed on a broken frame\n");
+                return false;
+            }
+        }
+
+        frames.clear();
+
+        {
+            std::vector<uint8_t> epoch(EpochBufferSize);
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), collectFrame, 1000U, &frames);
+            reassembler.enableAuthentication(key, epoch.data(), static_cast<uint16_t>(epoch.size()));
+            reassemble(reassembler, authenticatedCollector, 0U);
+
+            // The first epoch is skipped, the reassembler cannot know it starts there.
+            const rover::RTCMReassembler::Statistics &statistics = reassembler.getStatistics();
+            if (frames.empty() || std::search(capture.begin(), capture.end(), frames.begin(), frames.end()) == capture.end() ||
+                statistics.rejectedEpochs != 0U || statistics.authenticatedEpochs + 1U != statistics.epochs)
+            {
+                std::fprintf(stderr, "The authenticated frames differ from the capture\n");
+                return false;
+            }
+        }
+
+        {
+            std::vector<uint8_t> epoch(EpochBufferSize);
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), countFrame, 1000U, nullptr);
+            reassembler.enableAuthentication(key, epoch.data(), static_cast<uint16_t>(epoch.size()));
+            reassemble(reassembler, authenticatedCollector, 0U, 5U);
+
+            if (reassembler.getStatistics().rejectedEpochs == 0U)
+            {
+                std::fprintf(stderr, "The authentication passed on a tampered epoch\n");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// @brief Checks that the rovers resolve the markers of the static frames back into the
+    ///  frames of the base station, also when the markers are authenticated.
+    bool checkStaticReassembly(const std::vector<uint8_t> &capture, const PacketCollector &staticCollector,
+                               const PacketCollector &authenticatedStaticCollector, const protocol::ChaskeyMac::Key &key)
+    {
+        const bool suppressed = staticCollector.staticCache->getStatistics().suppressed != 0U;
+        std::vector<uint8_t> frames;
+        uint8_t storage[rover::RTCMReassembler::MaxFrameSize];
+
+        {
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), collectFrame, 1000U, &frames);
+            reassemble(reassembler, staticCollector, 0U);
+
+            const rover::RTCMReassembler::Statistics &statistics = reassembler.getStatistics();
+            if (frames.empty() || frames.size() > capture.size() || !std::equal(frames.begin(), frames.end(), capture.begin()) ||
+                statistics.unresolvedMarkers != 0U || (statistics.resolvedMarkers != 0U) != suppressed)
+            {
+                std::fprintf(stderr, "The frames resolved from the markers differ from the capture\n");
+                return false;
+            }
+        }
+
+        {
+            std::vector<uint8_t> epoch(EpochBufferSize);
+            rover::RTCMReassembler reassembler(storage, sizeof(storage), countFrame, 1000U, nullptr);
+            reassembler.enableAuthentication(key, epoch.data(), static_cast<uint16_t>(epoch.size()));
+            reassemble(reassembler, authenticatedStaticCollector, 0U);
+
+            // The markers up to the first refresh after the skipped first epoch stay unresolved.
+            const rover::RTCMReassembler::Statistics &statistics = reassembler.getStatistics();
+            if (statistics.rejectedEpochs != 0U || (statistics.resolvedMarkers != 0U) != suppressed)
+            {
+                std::fprintf(stderr, "The authenticated markers were not resolved\n");
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *capturePath = nullptr;
+    const char *jsonPath = nullptr;
+    const char *logDirectory = "bench_log";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+            capturePath = argv[++i];
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--log-dir") == 0 && i + 1 < argc)
+            logDirectory = argv[++i];
+    }
+
+    std::vector<uint8_t> capture;
+    if (capturePath != nullptr)
+    {
+        if (!readCapture(capturePath, capture))
+        {
+            std::fprintf(stderr, "Cannot read capture %s\n", capturePath);
+            return 1;
+        }
+    }
+    else
+    {
+        capture = synthesizeCapture(SynthesizedEpochs);
+    }
+
+    const double bytes = static_cast<double>(capture.size());
+    std::vector<Result> results;
+
+    // The parser alone, every byte of the stream.
+    {
+        RTCMParser parser;
+        const double seconds = measure([&]() {
+            uint32_t frames = 0U;
+            for (uint8_t byte : capture)
+                frames += parser.push(byte) == RTCMParser::Result::Frame;
+            g_Sink += frames;
+        });
+
+        results.push_back({"rtcm_parser_ingest", seconds * 1e9 / bytes, 0.0, 0.0});
+    }
+
+    // The ingest of MyGPS::processRTCM, parsing and buffering into epochs, without sending.
+    {
+        uint8_t storage[EpochBufferSize];
+        BurstCounter counter = {};
+        RTCMEpochBuffer buffer(storage, sizeof(storage), flushEpoch, mayFlushEpoch, &counter);
+
+        // Every synthesized epoch must go out as one burst, although the GPS and GLONASS
+        //  MSMs carry different epoch times.
+        for (uint8_t byte : capture)
+            buffer.push(byte);
+
+        if (capturePath == nullptr && counter.epochs != SynthesizedEpochs)
+        {
+            std::fprintf(stderr, "The %d synthesized epochs were flushed as %u bursts\n", SynthesizedEpochs,
+                         static_cast<unsigned>(counter.epochs));
+            return 1;
+        }
+
+        const double seconds = measure([&]() {
+            counter.packets = 0U;
+            for (uint8_t byte : capture)
+                buffer.push(byte);
+        });
+
+        results.push_back({"epoch_buffer_ingest", seconds * 1e9 / bytes, 0.0, 0.0});
+    }
+
+    // The ingest including the chunking and packet construction of MyCom.
+    {
+        uint8_t storage[EpochBufferSize];
+        BurstCounter counter = {};
+        counter.buildPackets = true;
+        RTCMEpochBuffer buffer(storage, sizeof(storage), flushEpoch, mayFlushEpoch, &counter);
+
+        const double seconds = measure([&]() {
+            counter.packets = 0U;
+            for (uint8_t byte : capture)
+                buffer.push(byte);
+        });
+
+        const double packets = static_cast<double>(counter.packets);
+        results.push_back({"epoch_to_packets", seconds * 1e9 / bytes, seconds * 1e9 / packets, packets / seconds});
+    }
+
+    // The packet construction alone, full chunks.
+    {
+        uint8_t packet[sizeof(protocol::RTCMStreamChunkHeader) + ChunkSize];
+        const uint32_t packets = static_cast<uint32_t>(capture.size() / ChunkSize);
+        uint16_t sequence = 0U;
+
+        const double seconds = measure([&]() {
+            for (uint32_t i = 0U; i < packets; ++i)
+                g_Sink += protocol::writeChunkPacket(packet, 0U, sequence++, 0U, &capture[i * ChunkSize], ChunkSize);
+        });
+
+        results.push_back({"chunk_packet_build", seconds * 1e9 / (packets * static_cast<double>(ChunkSize)),
+                           seconds * 1e9 / packets, packets / seconds});
+    }
+
+    // The raw broadcast packet construction alone, full packets.
+    {
+        uint8_t packet[protocol::RawPacketSize];
+        const uint32_t packets = static_cast<uint32_t>(capture.size() / protocol::RawPayloadSize);
+        uint16_t sequence = 0U;
+
+        const double seconds = measure([&]() {
+            for (uint32_t i = 0U; i < packets; ++i)
+                g_Sink += protocol::writeRawChunkPacket(packet, 0U, sequence++, 0U, &capture[i * protocol::RawPayloadSize],
+                                                        protocol::RawPayloadSize);
+        });
+
+        results.push_back({"raw_chunk_packet_build", seconds * 1e9 / (packets * static_cast<double>(protocol::RawPayloadSize)),
+                           seconds * 1e9 / packets, packets / seconds});
+    }
+
+    // The store of every flushed epoch in the frame pool, with the previous epoch still held
+    //  by the repair cache, as on the Mega with a pool of two epochs.
+    {
+        RTCMFramePool::Block blocks[2U * EpochBufferSize / RTCMFramePool::BlockSize];
+        RTCMFramePool pool(blocks, sizeof(blocks) / sizeof(blocks[0]));
+        const uint32_t epochs = static_cast<uint32_t>(capture.size() / EpochBufferSize);
+        uint32_t failed = 0U;
+
+        const double seconds = measure([&]() {
+            RTCMFramePool::Handle previous = RTCMFramePool::NoBlock;
+
+            for (uint32_t i = 0U; i < epochs; ++i)
+            {
+                const RTCMFramePool::Handle handle = pool.store(&capture[i * EpochBufferSize], EpochBufferSize);
+                g_Sink += handle;
+
+                if (handle == RTCMFramePool::NoBlock)
+                    ++failed;
+
+                if (previous != RTCMFramePool::NoBlock)
+                    pool.release(previous);
+
+                previous = handle;
+            }
+
+            if (previous != RTCMFramePool::NoBlock)
+                pool.release(previous);
+        });
+
+        if (failed != 0U)
+        {
+            std::fprintf(stderr, "The frame pool could not store %u epochs\n", static_cast<unsigned>(failed));
+            return 1;
+        }
+
+        results.push_back({"frame_pool_store", seconds * 1e9 / (epochs * static_cast<double>(EpochBufferSize)), 0.0, 0.0});
+    }
+
+    // The append of the frames to the write-behind blocks of the log, which is what the
+    //  radio path pays, with the blocks written to files on the host in between.
+    {
+        HostLogStorage storage(logDirectory);
+        uint8_t blocks[3U * RTCMLogWriter::BlockSize];
+        RTCMLogWriter writer(storage, blocks, 3U, 4194304UL);
+
+        if (!writer.begin(0U))
+        {
+            std::fprintf(stderr, "Cannot start the log in %s\n", logDirectory);
+            return 1;
+        }
+
+        double appendSeconds = 0.0;
+        double appendBytes = 0.0;
+
+        // Runs a fixed number of passes, every pass writes the whole capture to the files.
+        for (int pass = 0; pass < 20; ++pass)
+        {
+            size_t offset = 0U;
+
+            while (offset + RTCMParser::HeaderSize <= capture.size())
+            {
+                const uint16_t frameSize = RTCMParser::HeaderSize + RTCMParser::CrcSize +
+                                           ((static_cast<uint16_t>(capture[offset + 1U] & 0x03U) << 8) | capture[offset + 2U]);
+                if (offset + frameSize > capture.size())
+                    break;
+
+                const auto start = std::chrono::steady_clock::now();
+                writer.appendFrames(0U, &capture[offset], frameSize);
+                appendSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                appendBytes += frameSize;
+
+                while (writer.hasPendingBlocks())
+                    writer.service(0U);
+
+                offset += frameSize;
+            }
+        }
+
+        // Writes the last partial block, so the log holds the whole capture.
+        writer.pad();
+        while (writer.hasPendingBlocks())
+            writer.service(0U);
+
+        if (writer.getStatistics().droppedRecords > 0U)
+            std::fprintf(stderr, "The log dropped %u records\n", static_cast<unsigned>(writer.getStatistics().droppedRecords));
+
+        results.push_back({"log_append", appendSeconds * 1e9 / appendBytes, 0.0, 0.0});
+
+        writer.end();
+    }
+
+    // The reassembly of the packets on the rovers, after checking it against the capture.
+    {
+        protocol::ChaskeyMac::Key key;
+        protocol::ChaskeyMac::expandKey(AuthKey, key);
+
+        protocol::RTCMStaticCache staticCache(StaticRefreshMillis);
+        protocol::RTCMStaticCache authenticatedStaticCache(StaticRefreshMillis);
+        PacketCollector collector = {};
+        PacketCollector authenticatedCollector = {};
+        PacketCollector staticCollector = {};
+        PacketCollector authenticatedStaticCollector = {};
+        authenticatedCollector.key = &key;
+        staticCollector.staticCache = &staticCache;
+        authenticatedStaticCollector.key = &key;
+        authenticatedStaticCollector.staticCache = &authenticatedStaticCache;
+
+        collect(capture, collector);
+        collect(capture, authenticatedCollector);
+        collect(capture, staticCollector);
+        collect(capture, authenticatedStaticCollector);
+
+        if (!checkReassembly(capture, collector, authenticatedCollector, key) ||
+            !checkStaticReassembly(capture, staticCollector, authenticatedStaticCollector, key))
+            return 1;
+
+        uint8_t frame[rover::RTCMReassembler::MaxFrameSize];
+        double chunkBytes = 0.0;
+        for (const std::vector<uint8_t> &packet : collector.packets)
+            chunkBytes += static_cast<double>(packet.size() - sizeof(protocol::RTCMStreamChunkHeader));
+
+        const double seconds = measure([&]() {
+            rover::RTCMReassembler reassembler(frame, sizeof(frame), countFrame, 1000U, nullptr);
+            reassemble(reassembler, collector, 0U);
+        });
+
+        const double packets = static_cast<double>(collector.packets.size());
+        results.push_back({"rover_reassembly", seconds * 1e9 / chunkBytes, seconds * 1e9 / packets, packets / seconds});
+
+        // The same with authentication, which holds the frames back until the tag is checked.
+        std::vector<uint8_t> epoch(EpochBufferSize);
+        const double authenticatedSeconds = measure([&]() {
+            rover::RTCMReassembler reassembler(frame, sizeof(frame), countFrame, 1000U, nullptr);
+            reassembler.enableAuthentication(key, epoch.data(), static_cast<uint16_t>(epoch.size()));
+            reassemble(reassembler, authenticatedCollector, 0U);
+        });
+
+        const double authenticatedPackets = static_cast<double>(authenticatedCollector.packets.size());
+        results.push_back({"rover_authenticated", authenticatedSeconds * 1e9 / chunkBytes,
+                           authenticatedSeconds * 1e9 / authenticatedPackets, authenticatedPackets / authenticatedSeconds});
+
+        // The same with the markers of the static frames, per byte of the capture since the
+        //  markers take fewer bytes on the air.
+        const double staticSeconds = measure([&]() {
+            rover::RTCMReassembler reassembler(frame, sizeof(frame), countFrame, 1000U, nullptr);
+            reassemble(reassembler, staticCollector, 0U);
+        });
+
+        const double staticPackets = static_cast<double>(staticCollector.packets.size());
+        results.push_back({"rover_static", staticSeconds * 1e9 / chunkBytes, staticSeconds * 1e9 / staticPackets,
+                           staticPackets / staticSeconds});
+    }
+
+    // The tag of every epoch, the whole cost MyCom pays for the authentication.
+    {
+        protocol::ChaskeyMac::Key key;
+        protocol::ChaskeyMac::expandKey(AuthKey, key);
+
+        const uint32_t epochs = static_cast<uint32_t>(capture.size() / EpochBufferSize);
+        uint8_t tag[protocol::EpochTagSize];
+
+        const double seconds = measure([&]() {
+            for (uint32_t i = 0U; i < epochs; ++i)
+            {
+                protocol::computeEpochTag(key, 0U, static_cast<uint16_t>(i), &capture[i * EpochBufferSize], EpochBufferSize, tag);
+                g_Sink += tag[0];
+            }
+        });
+
+        results.push_back({"epoch_tag", seconds * 1e9 / (epochs * static_cast<double>(EpochBufferSize)), 0.0, 0.0});
+    }
+
+    // Prints the results, and writes them as JSON.
+    std::printf("%-24s %12s %12s %14s\n", "benchmark", "ns/byte", "ns/packet", "packets/s");
+    for (const Result &result : results)
+        std::printf("%-24s %12.2f %12.2f %14.0f\n", result.name.c_str(), result.nsPerByte,
+                    result.nsPerPacket, result.packetsPerSecond);
+
+    if (jsonPath != nullptr)
+    {
+        FILE *file = std::fopen(jsonPath, "w");
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "Cannot write %s\n", jsonPath);
+            return 1;
+        }
+
+        std::fprintf(file, "{\n  \"capture_bytes\": %zu,\n  \"benchmarks\": [\n", capture.size());
+        for (size_t i = 0U; i < results.size(); ++i)
+            std::fprintf(file, "    {\"name\": \"%s\", \"ns_per_byte\": %.3f, \"ns_per_packet\": %.3f, \"packets_per_second\": %.0f}%s\n",
+                         results[i].name.c_str(), results[i].nsPerByte, results[i].nsPerPacket,
+                         results[i].packetsPerSecond, i + 1U < results.size() ? "," : "");
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "ChaskeyMac.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Rotates the given word to the left.
+    static inline uint32_t rotateLeft(uint32_t value, uint8_t count) noexcept
+    {
+        return (value << count) | (value >> (32U - count));
+    }
+
+    /// @brief Multiplies the given 128-bit value by x in GF(2^128), to derive a subkey.
+    static void timesTwo(uint32_t out[4], const uint32_t in[4]) noexcept
+    {
+        const uint32_t carry = (in[3] & 0x80000000UL) != 0U ? 0x87UL : 0UL;
+
+        out[0] = (in[0] << 1) ^ carry;
+        out[1] = (in[1] << 1) | (in[0] >> 31);
+        out[2] = (in[2] << 1) | (in[1] >> 31);
+        out[3] = (in[3] << 1) | (in[2] >> 31);
+    }
+
+    /// @brief The Chaskey permutation, 8 rounds.
+    static void permute(uint32_t v[4]) noexcept
+    {
+        for (uint8_t i = 0U; i < 8U; ++i)
+        {
+            v[0] += v[1];
+            v[1] = rotateLeft(v[1], 5) ^ v[0];
+            v[0] = rotateLeft(v[0], 16);
+            v[2] += v[3];
+            v[3] = rotateLeft(v[3], 8) ^ v[2];
+            v[0] += v[3];
+            v[3] = rotateLeft(v[3], 13) ^ v[0];
+            v[2] += v[1];
+            v[1] = rotateLeft(v[1], 7) ^ v[2];
+            v[2] = rotateLeft(v[2], 16);
+        }
+    }
+
+    /// @brief Derives the subkeys from the given key.
+    /// @param key the 128-bit key, as four little-endian words.
+    /// @param expandedKey the key and its subkeys.
+    void ChaskeyMac::expandKey(const uint32_t key[4], Key &expandedKey) noexcept
+    {
+        memcpy(expandedKey.key, key, sizeof(expandedKey.key));
+        timesTwo(expandedKey.key1, expandedKey.key);
+        timesTwo(expandedKey.key2, expandedKey.key1);
+    }
+
+    /// @brief Constructs a new MAC, begin must be called before the message is added.
+    ChaskeyMac::ChaskeyMac(void) noexcept
+        : key_(nullptr),
+          state_(),
+          block_(),
+          blockSize_(0U)
+    {
+    }
+
+    /// @brief Starts a new, empty message.
+    /// @param key the expanded key, which must outlive the message.
+    void ChaskeyMac::begin(const Key &key) noexcept
+    {
+        this->key_ = &key;
+        memcpy(this->state_, key.key, sizeof(this->state_));
+        this->blockSize_ = 0U;
+    }
+
+    /// @brief Adds the given data to the message.
+    /// @param data the data.
+    /// @param dataSize the size of the data.
+    void ChaskeyMac::update(const uint8_t *data, uint16_t dataSize) noexcept
+    {
+        // A full block is only absorbed once more data follows, since the last block is
+        //  finished with a subkey.
+        while (dataSize > 0U)
+        {
+            if (this->blockSize_ == BlockSize)
+            {
+                this->absorb(this->block_);
+                this->blockSize_ = 0U;
+            }
+
+            // Absorbs whole blocks straight from the data while there is more after them.
+            if (this->blockSize_ == 0U && dataSize > BlockSize)
+            {
+                this->absorb(data);
+                data += BlockSize;
+                dataSize -= BlockSize;
+                continue;
+            }
+
+            const uint8_t size = static_cast<uint8_t>(dataSize < BlockSize - this->blockSize_ ? dataSize : BlockSize - this->blockSize_);
+            memcpy(this->block_ + this->blockSize_, data, size);
+            this->blockSize_ += size;
+            data += size;
+            dataSize -= size;
+        }
+    }
+
+    /// @brief Completes the message and writes the tag, truncated to the given size, begin
+    ///  must be called again for the next message.
+    /// @param tag the tag to write.
+    /// @param tagSize the size of the tag, at most BlockSize.
+    void ChaskeyMac::finish(uint8_t *tag, uint8_t tagSize) noexcept
+    {
+        const uint32_t *subkey = this->key_->key1;
+
+        // Pads a partial (or empty) last block, and finishes it with the other subkey.
+        if (this->blockSize_ < BlockSize)
+        {
+            this->block_[this->blockSize_] = 0x01U;
+            memset(this->block_ + this->blockSize_ + 1U, 0, BlockSize - this->blockSize_ - 1U);
+            subkey = this->key_->key2;
+        }
+
+        uint32_t words[4];
+        memcpy(words, this->block_, sizeof(words));
+
+        for (uint8_t i = 0U; i < 4U; ++i)
+            this->state_[i] ^= words[i] ^ subkey[i];
+
+        permute(this->state_);
+
+        for (uint8_t i = 0U; i < 4U; ++i)
+            this->state_[i] ^= subkey[i];
+
+        memcpy(tag, this->state_, tagSize);
+    }
+
+    /// @brief Adds the given block to the state and permutes it.
+    /// @param block the block.
+    void ChaskeyMac::absorb(const uint8_t *block) noexcept
+    {
+        // Both AVR and ARM are little-endian, so the words are copied as they are.
+        uint32_t words[4];
+        memcpy(words, block, sizeof(words));
+
+        for (uint8_t i = 0U; i < 4U; ++i)
+            this->state_[i] ^= words[i];
+
+        permute(this->state_);
+    }
+
+    /// @brief Starts the tag of an epoch whose frames are added later, see computeEpochTag.
+    /// @param mac the MAC to start.
+    /// @param key the expanded key.
+    /// @param station the station ID.
+    /// @param firstSequence the sequence number of the first chunk of the epoch.
+    void beginEpochTag(ChaskeyMac &mac, const ChaskeyMac::Key &key, uint8_t station, uint16_t firstSequence) noexcept
+    {
+        const uint8_t prefix[3] = {
+            station,
+            static_cast<uint8_t>(firstSequence),
+            static_cast<uint8_t>(firstSequence >> 8),
+        };
+
+        mac.begin(key);
+        mac.update(prefix, sizeof(prefix));
+    }
+
+    /// @brief Computes the tag of an epoch, over the station, the sequence number of its
+    ///  first chunk and its frames.
+    /// @param key the expanded key.
+    /// @param station the station ID.
+    /// @param firstSequence the sequence number of the first chunk of the epoch.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param tag the tag to write, EpochTagSize bytes.
+    void computeEpochTag(const ChaskeyMac::Key &key, uint8_t station, uint16_t firstSequence,
+                         const uint8_t *epoch, uint16_t epochSize, uint8_t *tag) noexcept
+    {
+        ChaskeyMac mac;
+
+        beginEpochTag(mac, key, station, firstSequence);
+        mac.update(epoch, epochSize);
+        mac.finish(tag, EpochTagSize);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief The size of the authentication tag at the end of an epoch.
+    static constexpr uint8_t EpochTagSize = 4U;
+
+    /// @brief The Chaskey MAC (8 rounds), a keyed MAC built from 32-bit additions, rotations
+    ///  and XORs only, so it needs no tables and is cheap on 8-bit AVR.
+    ///
+    /// The message is fed incrementally, only the current 16 byte block is buffered.
+    class ChaskeyMac
+    {
+    public:
+        /// @brief The size of a block and of the key.
+        static constexpr uint8_t BlockSize = 16U;
+
+        /// @brief The key and the two subkeys derived from it.
+        struct Key
+        {
+        public:
+            uint32_t key[4];
+            uint32_t key1[4];
+            uint32_t key2[4];
+        };
+
+        /// @brief Derives the subkeys from the given key.
+        /// @param key the 128-bit key, as four little-endian words.
+        /// @param expandedKey the key and its subkeys.
+        static void expandKey(const uint32_t key[4], Key &expandedKey) noexcept;
+
+    private:
+        const Key *key_;
+        uint32_t state_[4];
+        uint8_t block_[BlockSize];
+        uint8_t blockSize_;
+
+    public:
+        /// @brief Constructs a new MAC, begin must be called before the message is added.
+        ChaskeyMac(void) noexcept;
+
+    public:
+        /// @brief Starts a new, empty message.
+        /// @param key the expanded key, which must outlive the message.
+        void begin(const Key &key) noexcept;
+
+        /// @brief Adds the given data to the message.
+        /// @param data the data.
+        /// @param dataSize the size of the data.
+        void update(const uint8_t *data, uint16_t dataSize) noexcept;
+
+        /// @brief Completes the message and writes the tag, truncated to the given size, begin
+        ///  must be called again for the next message.
+        /// @param tag the tag to write.
+        /// @param tagSize the size of the tag, at most BlockSize.
+        void finish(uint8_t *tag, uint8_t tagSize) noexcept;
+
+    private:
+        /// @brief Adds the given block to the state and permutes it.
+        /// @param block the block.
+        void absorb(const uint8_t *block) noexcept;
+    };
+
+    /// @brief Computes the tag of an epoch, over the station, the sequence number of its
+    ///  first chunk and its frames.
+    /// @param key the expanded key.
+    /// @param station the station ID.
+    /// @param firstSequence the sequence number of the first chunk of the epoch.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param tag the tag to write, EpochTagSize bytes.
+    void computeEpochTag(const ChaskeyMac::Key &key, uint8_t station, uint16_t firstSequence,
+                         const uint8_t *epoch, uint16_t epochSize, uint8_t *tag) noexcept;
+
+    /// @brief Starts the tag of an epoch whose frames are added later, see computeEpochTag.
+    /// @param mac the MAC to start.
+    /// @param key the expanded key.
+    /// @param station the station ID.
+    /// @param firstSequence the sequence number of the first chunk of the epoch.
+    void beginEpochTag(ChaskeyMac &mac, const ChaskeyMac::Key &key, uint8_t station, uint16_t firstSequence) noexcept;
+}
@@ -0,0 +1,110 @@
+#include "DroidProtocol.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Writes an RTCM stream chunk packet, the header followed by the data.
+    /// @param packet the packet to write, with room for the header and the data.
+    /// @param station the station ID.
+    /// @param sequence the sequence number.
+    /// @param flags the chunk flags.
+    /// @param chunk the data of the chunk.
+    /// @param chunkSize the size of the data.
+    /// @return the size of the packet.
+    uint8_t writeChunkPacket(uint8_t *packet, uint8_t station, uint16_t sequence, uint8_t flags,
+                             const uint8_t *chunk, uint8_t chunkSize) noexcept
+    {
+        RTCMStreamChunkHeader &header = *reinterpret_cast<RTCMStreamChunkHeader *>(packet);
+
+        header.station = station;
+        header.sequence = sequence;
+        header.flags = flags;
+        memcpy(packet + sizeof(RTCMStreamChunkHeader), chunk, chunkSize);
+
+        return static_cast<uint8_t>(sizeof(RTCMStreamChunkHeader) + chunkSize);
+    }
+
+    /// @brief Writes a raw broadcast RTCM stream chunk packet, the raw header followed by the data.
+    /// @param packet the packet to write, with room for the header and the data.
+    /// @param station the station ID, at most RawMaxStation.
+    /// @param sequence the sequence number.
+    /// @param flags the chunk flags.
+    /// @param chunk the data of the chunk, at most RawPayloadSize.
+    /// @param chunkSize the size of the data.
+    /// @return the size of the packet.
+    uint8_t writeRawChunkPacket(uint8_t *packet, uint8_t station, uint16_t sequence, uint8_t flags,
+                                const uint8_t *chunk, uint8_t chunkSize) noexcept
+    {
+        RawHeader &header = *reinterpret_cast<RawHeader *>(packet);
+
+        header.control = makeRawControl(PacketType::RTCMStreamChunk, station, flags);
+        header.sequence = sequence;
+        memcpy(packet + sizeof(RawHeader), chunk, chunkSize);
+
+        return static_cast<uint8_t>(sizeof(RawHeader) + chunkSize);
+    }
+
+    /// @brief Reads an RTCM stream chunk packet written by writeChunkPacket.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param header the header of the chunk.
+    /// @param chunk the data of the chunk, within the packet.
+    /// @param chunkSize the size of the data.
+    /// @return false if the packet is too small to carry a chunk.
+    bool readChunkPacket(const uint8_t *packet, uint8_t packetSize, RTCMStreamChunkHeader &header,
+                         const uint8_t *&chunk, uint8_t &chunkSize) noexcept
+    {
+        if (packetSize < sizeof(RTCMStreamChunkHeader))
+            return false;
+
+        memcpy(&header, packet, sizeof(RTCMStreamChunkHeader));
+        chunk = packet + sizeof(RTCMStreamChunkHeader);
+        chunkSize = static_cast<uint8_t>(packetSize - sizeof(RTCMStreamChunkHeader));
+
+        return true;
+    }
+
+    /// @brief Reads a raw broadcast RTCM stream chunk packet written by writeRawChunkPacket.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param header the header of the chunk, taken from the control byte.
+    /// @param chunk the data of the chunk, within the packet.
+    /// @param chunkSize the size of the data.
+    /// @return false if the packet is too small or is not an RTCM stream chunk.
+    bool readRawChunkPacket(const uint8_t *packet, uint8_t packetSize, RTCMStreamChunkHeader &header,
+                            const uint8_t *&chunk, uint8_t &chunkSize) noexcept
+    {
+        if (packetSize < sizeof(RawHeader))
+            return false;
+
+        RawHeader rawHeader;
+        memcpy(&rawHeader, packet, sizeof(RawHeader));
+
+        if (getRawType(rawHeader.control) != PacketType::RTCMStreamChunk)
+            return false;
+
+        header.station = getRawStation(rawHeader.control);
+        header.sequence = rawHeader.sequence;
+        header.flags = getRawFlags(rawHeader.control);
+        chunk = packet + sizeof(RawHeader);
+        chunkSize = static_cast<uint8_t>(packetSize - sizeof(RawHeader));
+
+        return true;
+    }
+
+    /// @brief Reads a raw broadcast channel announcement.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param announcement the announcement.
+    /// @return false if the packet is too small or is not a channel announcement.
+    bool readRawChannelPacket(const uint8_t *packet, uint8_t packetSize, ChannelAnnouncement &announcement) noexcept
+    {
+        if (packetSize < sizeof(RawHeader) + sizeof(ChannelAnnouncement) ||
+            getRawType(packet[0]) != PacketType::Channel)
+            return false;
+
+        memcpy(&announcement, packet + sizeof(RawHeader), sizeof(ChannelAnnouncement));
+
+        return true;
+    }
+}
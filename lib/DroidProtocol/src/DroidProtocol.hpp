@@ -0,0 +1,220 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief The type of a packet, carried in the type of the RF24Network header or in the
+    ///  control byte of a raw broadcast packet.
+    enum class PacketType : uint8_t
+    {
+        RTCMStreamChunk = 0,
+        Nack = 1,
+        Schedule = 2,
+        Channel = 3,
+    };
+
+    /// @brief The flags of an RTCM stream chunk.
+    enum ChunkFlag : uint8_t
+    {
+        ChunkFlagRepair = 0x01,
+        ChunkFlagEpochEnd = 0x02,
+    };
+
+    /// @brief The header in front of the data of every RTCM stream chunk.
+    struct __attribute__((packed)) RTCMStreamChunkHeader
+    {
+    public:
+        uint8_t station;
+        uint16_t sequence;
+        uint8_t flags;
+    };
+
+    /// @brief The header of a NACK from a rover, followed by the missing ranges.
+    struct __attribute__((packed)) NackHeader
+    {
+    public:
+        uint8_t station;
+    };
+
+    /// @brief A range of missing chunks in a NACK.
+    struct __attribute__((packed)) NackRange
+    {
+    public:
+        uint16_t firstSequence;
+        uint8_t count;
+    };
+
+    /// @brief The TDMA schedule of a base station, announced once per frame.
+    struct __attribute__((packed)) ScheduleAnnouncement
+    {
+    public:
+        uint8_t station;
+        uint32_t slotLength;
+        uint16_t correctionSlots;
+        uint16_t uplinkSlots;
+        uint8_t slotCount;
+    };
+
+    /// @brief The announcement of a base station that moves to another channel, repeated with a
+    ///  decreasing countdown, the station switches right after the announcement with countdown 0.
+    struct __attribute__((packed)) ChannelAnnouncement
+    {
+    public:
+        uint8_t station;
+        uint8_t channel;
+        uint8_t countdown;
+    };
+
+    /// @brief The size of the largest epoch a base station sends, its epoch buffer on the
+    ///  STM32, which a rover that checks the tags holds until the end of the epoch.
+    static constexpr uint16_t MaxEpochSize = 4096U;
+
+    /// @brief The number of static RTCM messages, sent in full only when they change or are
+    ///  refreshed, and as a marker in between.
+    static constexpr uint8_t StaticMessageCount = 2U;
+
+    /// @brief The index that refers to no static message.
+    static constexpr uint8_t NoStaticMessage = 0xFFU;
+
+    /// @brief The size of the largest static frame that is replaced by a marker, and cached.
+    static constexpr uint8_t MaxStaticFrameSize = 32U;
+
+    /// @brief The first byte of a marker, in place of the preamble of the frame it replaces.
+    static constexpr uint8_t StaticMarkerPreamble = 0xD4U;
+
+    /// @brief The marker sent in place of an unchanged static frame, the rovers resolve it
+    ///  from the last full frame they received with the same message number and CRC.
+    struct __attribute__((packed)) StaticMarker
+    {
+    public:
+        uint8_t preamble;
+        uint16_t messageNumber;
+        uint8_t crc[3];
+    };
+
+    /// @brief Gets the index of the given static message.
+    /// @param messageNumber the message number, 1005 (station ARP) or 1230 (GLONASS biases).
+    /// @return the index, or NoStaticMessage if the message is not static.
+    static inline uint8_t getStaticMessageIndex(uint16_t messageNumber) noexcept
+    {
+        return messageNumber == 1005U ? 0U : messageNumber == 1230U ? 1U : NoStaticMessage;
+    }
+
+    /// @brief Gets the message number of the given static message.
+    /// @param index the index of the static message.
+    /// @return the message number.
+    static inline uint16_t getStaticMessageNumber(uint8_t index) noexcept
+    {
+        return index == 0U ? 1005U : 1230U;
+    }
+
+    /// @brief Gets the message number of the given RTCM frame.
+    /// @param frame the frame, with at least two bytes of payload.
+    /// @return the message number.
+    static inline uint16_t getFrameMessageNumber(const uint8_t *frame) noexcept
+    {
+        return static_cast<uint16_t>((static_cast<uint16_t>(frame[3]) << 4) | (frame[4] >> 4));
+    }
+
+    /// @brief The address of the raw broadcast, the rovers listen on it with reading pipe 0
+    ///  instead of the multicast address of RF24Network.
+    static constexpr uint64_t RawBroadcastAddress = 0xD2B4C3A5E1ULL;
+
+    /// @brief The size of a raw broadcast packet, a full nRF24 payload.
+    static constexpr uint8_t RawPacketSize = 32U;
+
+    /// @brief The header of a raw broadcast packet, sent without RF24Network.
+    ///
+    /// The control byte carries the packet type in the upper two bits, the chunk flags in
+    ///  the two bits below them and the station ID in the lower four bits.
+    struct __attribute__((packed)) RawHeader
+    {
+    public:
+        uint8_t control;
+        uint16_t sequence;
+    };
+
+    /// @brief The data that fits in a raw broadcast packet after the header.
+    static constexpr uint8_t RawPayloadSize = RawPacketSize - sizeof(RawHeader);
+
+    /// @brief The highest station ID that fits in the control byte.
+    static constexpr uint8_t RawMaxStation = 0x0FU;
+
+    /// @brief Builds the control byte of a raw broadcast packet.
+    /// @param type the packet type.
+    /// @param station the station ID.
+    /// @param flags the chunk flags.
+    /// @return the control byte.
+    static inline constexpr uint8_t makeRawControl(PacketType type, uint8_t station, uint8_t flags) noexcept
+    {
+        return static_cast<uint8_t>((static_cast<uint8_t>(type) << 6) | ((flags & 0x03U) << 4) | (station & RawMaxStation));
+    }
+
+    /// @brief Gets the packet type from the control byte of a raw broadcast packet.
+    static inline constexpr PacketType getRawType(uint8_t control) noexcept
+    {
+        return static_cast<PacketType>(control >> 6);
+    }
+
+    /// @brief Gets the chunk flags from the control byte of a raw broadcast packet.
+    static inline constexpr uint8_t getRawFlags(uint8_t control) noexcept
+    {
+        return static_cast<uint8_t>((control >> 4) & 0x03U);
+    }
+
+    /// @brief Gets the station ID from the control byte of a raw broadcast packet.
+    static inline constexpr uint8_t getRawStation(uint8_t control) noexcept
+    {
+        return static_cast<uint8_t>(control & RawMaxStation);
+    }
+
+    /// @brief Writes an RTCM stream chunk packet, the header followed by the data.
+    /// @param packet the packet to write, with room for the header and the data.
+    /// @param station the station ID.
+    /// @param sequence the sequence number.
+    /// @param flags the chunk flags.
+    /// @param chunk the data of the chunk.
+    /// @param chunkSize the size of the data.
+    /// @return the size of the packet.
+    uint8_t writeChunkPacket(uint8_t *packet, uint8_t station, uint16_t sequence, uint8_t flags,
+                             const uint8_t *chunk, uint8_t chunkSize) noexcept;
+
+    /// @brief Writes a raw broadcast RTCM stream chunk packet, the raw header followed by the data.
+    /// @param packet the packet to write, with room for the header and the data.
+    /// @param station the station ID, at most RawMaxStation.
+    /// @param sequence the sequence number.
+    /// @param flags the chunk flags.
+    /// @param chunk the data of the chunk, at most RawPayloadSize.
+    /// @param chunkSize the size of the data.
+    /// @return the size of the packet.
+    uint8_t writeRawChunkPacket(uint8_t *packet, uint8_t station, uint16_t sequence, uint8_t flags,
+                                const uint8_t *chunk, uint8_t chunkSize) noexcept;
+
+    /// @brief Reads an RTCM stream chunk packet written by writeChunkPacket.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param header the header of the chunk.
+    /// @param chunk the data of the chunk, within the packet.
+    /// @param chunkSize the size of the data.
+    /// @return false if the packet is too small to carry a chunk.
+    bool readChunkPacket(const uint8_t *packet, uint8_t packetSize, RTCMStreamChunkHeader &header,
+                         const uint8_t *&chunk, uint8_t &chunkSize) noexcept;
+
+    /// @brief Reads a raw broadcast RTCM stream chunk packet written by writeRawChunkPacket.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param header the header of the chunk, taken from the control byte.
+    /// @param chunk the data of the chunk, within the packet.
+    /// @param chunkSize the size of the data.
+    /// @return false if the packet is too small or is not an RTCM stream chunk.
+    bool readRawChunkPacket(const uint8_t *packet, uint8_t packetSize, RTCMStreamChunkHeader &header,
+                            const uint8_t *&chunk, uint8_t &chunkSize) noexcept;
+
+    /// @brief Reads a raw broadcast channel announcement.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @param announcement the announcement.
+    /// @return false if the packet is too small or is not a channel announcement.
+    bool readRawChannelPacket(const uint8_t *packet, uint8_t packetSize, ChannelAnnouncement &announcement) noexcept;
+}
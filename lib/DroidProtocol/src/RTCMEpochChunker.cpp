@@ -0,0 +1,100 @@
+#include "RTCMEpochChunker.hpp"
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Constructs a new chunker of the given epoch.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param chunkSize the largest chunk, at least the markers and the tag together.
+    /// @param tagSize the size of the tag sent after the last chunk, or zero.
+    /// @param staticCache the cache of the static frames, or nullptr to send every frame in full.
+    /// @param currentMillis the current time, for the refresh of the static frames.
+    RTCMEpochChunker::RTCMEpochChunker(const uint8_t *epoch, uint16_t epochSize, uint8_t chunkSize, uint8_t tagSize,
+                                       RTCMStaticCache *staticCache, uint32_t currentMillis) noexcept
+        : staticCache_(staticCache),
+          epoch_(epoch),
+          epochSize_(epochSize),
+          currentMillis_(currentMillis),
+          chunkSize_(chunkSize),
+          tagSize_(tagSize),
+          offset_(0U),
+          end_(0U),
+          next_(0U),
+          markers_(0U),
+          scanned_(false),
+          framesDone_(false),
+          done_(false),
+          markerChunk_()
+    {
+    }
+
+    /// @brief Takes the next chunk of the epoch.
+    /// @param chunk the chunk, its data is either in the epoch at its offset, or in the
+    ///  chunker if it holds markers.
+    /// @return false once the chunk with the epoch end flag has been taken.
+    bool RTCMEpochChunker::next(Chunk &chunk) noexcept
+    {
+        if (this->done_)
+            return false;
+
+        if (!this->scanned_)
+            this->scan();
+
+        // Takes the frames sent in full first. The last chunk of the epoch leaves room for
+        //  the tag, if it does not fit the tag goes with an empty chunk of its own.
+        if (!this->framesDone_)
+        {
+            const uint16_t left = this->end_ - this->offset_;
+            const uint8_t size = static_cast<uint8_t>(left < this->chunkSize_ ? left : this->chunkSize_);
+            const bool ends = this->offset_ + size == this->end_;
+            const bool lastPart = this->markers_ == 0U;
+            const bool last = lastPart && ends && size + this->tagSize_ <= this->chunkSize_;
+
+            chunk.data = this->epoch_ + this->offset_;
+            chunk.offset = this->offset_;
+            chunk.size = size;
+            chunk.flags = last ? static_cast<uint8_t>(ChunkFlagEpochEnd) : static_cast<uint8_t>(0U);
+            chunk.markers = 0U;
+
+            this->offset_ += size;
+            this->framesDone_ = ends && (last || !lastPart);
+            this->done_ = last;
+            return true;
+        }
+
+        // Then the markers of the unchanged frames that follow them, which end the epoch if
+        //  nothing follows them in turn.
+        const bool last = this->next_ == this->epochSize_;
+
+        chunk.data = this->markerChunk_;
+        chunk.offset = 0U;
+        chunk.size = this->staticCache_->writeMarkers(this->markers_, this->markerChunk_);
+        chunk.flags = last ? static_cast<uint8_t>(ChunkFlagEpochEnd) : static_cast<uint8_t>(0U);
+        chunk.markers = this->markers_;
+
+        this->offset_ = this->next_;
+        this->scanned_ = false;
+        this->done_ = last;
+        return true;
+    }
+
+    /// @brief Scans the frames from the offset, up to the next run of unchanged static frames.
+    void RTCMEpochChunker::scan(void) noexcept
+    {
+        if (this->staticCache_ != nullptr)
+        {
+            this->end_ = this->staticCache_->scan(this->epoch_, this->epochSize_, this->offset_, this->currentMillis_,
+                                                  this->markers_, this->next_);
+        }
+        else
+        {
+            this->end_ = this->epochSize_;
+            this->markers_ = 0U;
+            this->next_ = this->epochSize_;
+        }
+
+        // A run of markers right at the offset has no frames in front of it.
+        this->scanned_ = true;
+        this->framesDone_ = this->offset_ == this->end_ && this->markers_ != 0U;
+    }
+}
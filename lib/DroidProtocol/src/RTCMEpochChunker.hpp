@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include "DroidProtocol.hpp"
+#include "RTCMStaticCache.hpp"
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Splits an epoch into the chunks of its burst, the way the rovers expect them.
+    ///
+    /// The last chunk carries the epoch end flag and leaves room for the tag of the epoch,
+    ///  which gets an empty chunk of its own if it does not fit. With a static cache, every
+    ///  run of unchanged static frames is replaced by a chunk with their markers.
+    class RTCMEpochChunker
+    {
+    public:
+        /// @brief A chunk of the epoch.
+        struct Chunk
+        {
+        public:
+            const uint8_t *data;
+            uint16_t offset;
+            uint8_t size;
+            uint8_t flags;
+            uint8_t markers;
+        };
+
+    private:
+        RTCMStaticCache *const staticCache_;
+        const uint8_t *const epoch_;
+        const uint16_t epochSize_;
+        const uint32_t currentMillis_;
+        const uint8_t chunkSize_;
+        const uint8_t tagSize_;
+        uint16_t offset_;
+        uint16_t end_;
+        uint16_t next_;
+        uint8_t markers_;
+        bool scanned_;
+        bool framesDone_;
+        bool done_;
+        uint8_t markerChunk_[StaticMessageCount * sizeof(StaticMarker)];
+
+    public:
+        /// @brief Constructs a new chunker of the given epoch.
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param chunkSize the largest chunk, at least the markers and the tag together.
+        /// @param tagSize the size of the tag sent after the last chunk, or zero.
+        /// @param staticCache the cache of the static frames, or nullptr to send every frame in full.
+        /// @param currentMillis the current time, for the refresh of the static frames.
+        RTCMEpochChunker(const uint8_t *epoch, uint16_t epochSize, uint8_t chunkSize, uint8_t tagSize,
+                         RTCMStaticCache *staticCache, uint32_t currentMillis) noexcept;
+
+    public:
+        /// @brief Takes the next chunk of the epoch.
+        /// @param chunk the chunk, its data is either in the epoch at its offset, or in the
+        ///  chunker if it holds markers.
+        /// @return false once the chunk with the epoch end flag has been taken.
+        /// @note The frames that follow a chunk with markers are only scanned when the next
+        ///  chunk is taken, so the static cache still holds the frames of those markers until then.
+        bool next(Chunk &chunk) noexcept;
+
+    private:
+        /// @brief Scans the frames from the offset, up to the next run of unchanged static frames.
+        void scan(void) noexcept;
+    };
+}
@@ -0,0 +1,179 @@
+#include "RTCMStaticCache.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief The size of the preamble and the length of a frame.
+    static constexpr uint8_t HeaderSize = 3U;
+
+    /// @brief The size of the CRC of a frame.
+    static constexpr uint8_t CrcSize = 3U;
+
+    /// @brief Gets the size of the frame at the given offset, from its length.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param offset the offset of the frame.
+    /// @return the size of the frame, at most what is left of the epoch.
+    static uint16_t getFrameSize(const uint8_t *epoch, uint16_t epochSize, uint16_t offset) noexcept
+    {
+        const uint16_t left = epochSize - offset;
+
+        if (left < HeaderSize)
+            return left;
+
+        const uint16_t frameSize = HeaderSize + CrcSize +
+                                   ((static_cast<uint16_t>(epoch[offset + 1U] & 0x03U) << 8) | epoch[offset + 2U]);
+
+        return frameSize < left ? frameSize : left;
+    }
+
+    /// @brief Gets the static message of the given frame.
+    /// @param frame the frame.
+    /// @param frameSize the size of the frame.
+    /// @return the index of the static message, or NoStaticMessage if the frame is not
+    ///  static or too large to be cached by the rovers.
+    static uint8_t getStaticIndex(const uint8_t *frame, uint16_t frameSize) noexcept
+    {
+        // The message number takes the first 12 bits of the payload.
+        if (frameSize < HeaderSize + 2U + CrcSize || frameSize > MaxStaticFrameSize)
+            return NoStaticMessage;
+
+        return getStaticMessageIndex(getFrameMessageNumber(frame));
+    }
+
+    /// @brief Constructs a new cache.
+    /// @param refreshMillis the interval at which an unchanged frame is sent in full.
+    RTCMStaticCache::RTCMStaticCache(uint32_t refreshMillis) noexcept
+        : entries_(),
+          statistics_(),
+          refreshMillis_(refreshMillis),
+          generation_(0U)
+    {
+    }
+
+    /// @brief Forgets the frames, so that the next ones are sent in full.
+    void RTCMStaticCache::reset(void) noexcept
+    {
+        for (Entry &entry : this->entries_)
+            entry.valid = false;
+    }
+
+    /// @brief Scans the frames of an epoch from the given offset, up to and including the
+    ///  first run of unchanged static frames.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param offset the offset of the first frame to scan.
+    /// @param currentMillis the current time.
+    /// @param markers the mask of the static messages whose frames follow the returned
+    ///  end, to be sent as markers, or zero if the scan reached the end of the epoch.
+    /// @param next the offset of the frame after those, where the next scan starts.
+    /// @return the end of the frames to send in full.
+    uint16_t RTCMStaticCache::scan(const uint8_t *epoch, uint16_t epochSize, uint16_t offset, uint32_t currentMillis,
+                                   uint8_t &markers, uint16_t &next) noexcept
+    {
+        uint16_t end = offset;
+        markers = 0U;
+
+        // Takes the frames that are sent in full, up to the first unchanged one.
+        while (end < epochSize)
+        {
+            const uint16_t frameSize = getFrameSize(epoch, epochSize, end);
+
+            if (this->findUnchanged(epoch + end, frameSize, currentMillis) != NoStaticMessage)
+                break;
+
+            this->record(epoch + end, frameSize, currentMillis);
+            end += frameSize;
+        }
+
+        // Takes the unchanged frames right after them, the next full frame starts the next
+        //  scan. The markers are written in the order of the mask, so a frame that would
+        //  come out of order starts the next scan too.
+        next = end;
+        while (next < epochSize)
+        {
+            const uint16_t frameSize = getFrameSize(epoch, epochSize, next);
+            const uint8_t index = this->findUnchanged(epoch + next, frameSize, currentMillis);
+
+            if (index == NoStaticMessage || (markers >> index) != 0U)
+                break;
+
+            markers |= static_cast<uint8_t>(1U << index);
+            ++this->statistics_.suppressed;
+            this->statistics_.savedBytes += frameSize - sizeof(StaticMarker);
+            next += frameSize;
+        }
+
+        return end;
+    }
+
+    /// @brief Writes the markers of the given static messages.
+    /// @param markers the mask of the static messages.
+    /// @param data the buffer to write to, large enough for every static message.
+    /// @return the size of the markers.
+    uint8_t RTCMStaticCache::writeMarkers(uint8_t markers, uint8_t *data) const noexcept
+    {
+        uint8_t size = 0U;
+
+        for (uint8_t i = 0U; i < StaticMessageCount; ++i)
+        {
+            if ((markers & static_cast<uint8_t>(1U << i)) == 0U)
+                continue;
+
+            StaticMarker marker;
+            marker.preamble = StaticMarkerPreamble;
+            marker.messageNumber = getStaticMessageNumber(i);
+            memcpy(marker.crc, this->entries_[i].crc, sizeof(marker.crc));
+
+            memcpy(data + size, &marker, sizeof(marker));
+            size += sizeof(marker);
+        }
+
+        return size;
+    }
+
+    /// @brief Gets the static message of the given frame, if it is unchanged.
+    /// @param frame the frame.
+    /// @param frameSize the size of the frame.
+    /// @param currentMillis the current time.
+    /// @return the index of the static message, or NoStaticMessage if the frame is to be sent in full.
+    uint8_t RTCMStaticCache::findUnchanged(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) const noexcept
+    {
+        const uint8_t index = getStaticIndex(frame, frameSize);
+
+        if (index == NoStaticMessage)
+            return NoStaticMessage;
+
+        const Entry &entry = this->entries_[index];
+
+        if (!entry.valid || currentMillis - entry.lastSentMillis >= this->refreshMillis_ ||
+            memcmp(entry.crc, frame + frameSize - CrcSize, CrcSize) != 0)
+            return NoStaticMessage;
+
+        return index;
+    }
+
+    /// @brief Remembers the given frame if it is static, since it is sent in full.
+    /// @param frame the frame.
+    /// @param frameSize the size of the frame.
+    /// @param currentMillis the current time.
+    void RTCMStaticCache::record(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) noexcept
+    {
+        const uint8_t index = getStaticIndex(frame, frameSize);
+
+        if (index == NoStaticMessage)
+            return;
+
+        Entry &entry = this->entries_[index];
+
+        // A changed frame changes the markers of its message.
+        if (memcmp(entry.crc, frame + frameSize - CrcSize, CrcSize) != 0)
+            ++this->generation_;
+
+        memcpy(entry.crc, frame + frameSize - CrcSize, CrcSize);
+        entry.lastSentMillis = currentMillis;
+        entry.valid = true;
+
+        ++this->statistics_.sent;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include "DroidProtocol.hpp"
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Remembers the last 1005 and 1230 frames sent in full, and replaces the
+    ///  unchanged ones by a marker the rovers resolve from their own copy.
+    ///
+    /// A frame is sent in full when it is the first of its message, when it changed, and
+    ///  once every refresh interval, so that a rover that joins later gets it too. The
+    ///  frames are compared on their CRC, which the marker carries as well.
+    class RTCMStaticCache
+    {
+    public:
+        /// @brief The last static frame sent in full.
+        struct Entry
+        {
+        public:
+            uint32_t lastSentMillis;
+            uint8_t crc[3];
+            bool valid;
+        };
+
+        /// @brief The counters of the cache.
+        struct Statistics
+        {
+        public:
+            uint32_t sent;
+            uint32_t suppressed;
+            uint32_t savedBytes;
+        };
+
+    private:
+        Entry entries_[StaticMessageCount];
+        Statistics statistics_;
+        const uint32_t refreshMillis_;
+        uint8_t generation_;
+
+    public:
+        /// @brief Constructs a new cache.
+        /// @param refreshMillis the interval at which an unchanged frame is sent in full.
+        explicit RTCMStaticCache(uint32_t refreshMillis) noexcept;
+
+    public:
+        /// @brief Gets the counters of the cache.
+        /// @return the statistics.
+        inline const Statistics &getStatistics(void) const noexcept
+        {
+            return this->statistics_;
+        }
+
+        /// @brief Gets the generation of the cache, which changes whenever a cached frame
+        ///  changes, so that markers written earlier can be told apart from the current ones.
+        /// @return the generation.
+        inline uint8_t getGeneration(void) const noexcept
+        {
+            return this->generation_;
+        }
+
+        /// @brief Forgets the frames, so that the next ones are sent in full.
+        void reset(void) noexcept;
+
+        /// @brief Scans the frames of an epoch from the given offset, up to and including the
+        ///  first run of unchanged static frames.
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param offset the offset of the first frame to scan.
+        /// @param currentMillis the current time.
+        /// @param markers the mask of the static messages whose frames follow the returned
+        ///  end, to be sent as markers, or zero if the scan reached the end of the epoch.
+        /// @param next the offset of the frame after those, where the next scan starts.
+        /// @return the end of the frames to send in full.
+        uint16_t scan(const uint8_t *epoch, uint16_t epochSize, uint16_t offset, uint32_t currentMillis,
+                      uint8_t &markers, uint16_t &next) noexcept;
+
+        /// @brief Writes the markers of the given static messages.
+        /// @param markers the mask of the static messages.
+        /// @param data the buffer to write to, large enough for every static message.
+        /// @return the size of the markers.
+        uint8_t writeMarkers(uint8_t markers, uint8_t *data) const noexcept;
+
+    private:
+        /// @brief Gets the static message of the given frame, if it is unchanged.
+        /// @param frame the frame.
+        /// @param frameSize the size of the frame.
+        /// @param currentMillis the current time.
+        /// @return the index of the static message, or NoStaticMessage if the frame is to be sent in full.
+        uint8_t findUnchanged(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) const noexcept;
+
+        /// @brief Remembers the given frame if it is static, since it is sent in full.
+        /// @param frame the frame.
+        /// @param frameSize the size of the frame.
+        /// @param currentMillis the current time.
+        void record(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) noexcept;
+    };
+}
@@ -0,0 +1,100 @@
+#include "StationSelector.hpp"
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Constructs a new station selector.
+    /// @param preferredStation the preferred station, or NoStation.
+    /// @param timeoutMillis the time after which a station that is not heard is lost.
+    StationSelector::StationSelector(uint8_t preferredStation, uint32_t timeoutMillis) noexcept
+        : stations_(),
+          timeoutMillis_(timeoutMillis),
+          preferredStation_(preferredStation),
+          selectedStation_(NoStation)
+    {
+    }
+
+    /// @brief Records a packet of the given station, and updates the selection.
+    /// @param station the station.
+    /// @param currentMillis the current time.
+    /// @return true if the packet is from the selected station.
+    bool StationSelector::heard(uint8_t station, uint32_t currentMillis) noexcept
+    {
+        Station *slot = nullptr;
+
+        // Finds the station, or a slot for it, replacing a lost station if needed.
+        for (uint8_t i = 0U; i < MaxStations; ++i)
+        {
+            Station &candidate = this->stations_[i];
+
+            if (candidate.used && candidate.id == station)
+            {
+                slot = &candidate;
+                break;
+            }
+
+            if (slot == nullptr && (!candidate.used || !this->isAlive(candidate, currentMillis)))
+                slot = &candidate;
+        }
+
+        // Ignores the station if all slots hold stations that are alive.
+        if (slot == nullptr)
+            return false;
+
+        if (!slot->used || slot->id != station)
+        {
+            slot->used = true;
+            slot->id = station;
+            slot->packets = 0U;
+        }
+
+        slot->lastHeardMillis = currentMillis;
+        if (slot->packets < UINT16_MAX)
+            ++slot->packets;
+
+        return this->select(currentMillis) == station;
+    }
+
+    /// @brief Updates the selection, dropping the stations that are lost.
+    /// @param currentMillis the current time.
+    /// @return the selected station, or NoStation.
+    uint8_t StationSelector::select(uint32_t currentMillis) noexcept
+    {
+        const Station *preferred = nullptr;
+        const Station *selected = nullptr;
+        const Station *best = nullptr;
+
+        for (uint8_t i = 0U; i < MaxStations; ++i)
+        {
+            const Station &station = this->stations_[i];
+
+            if (!station.used || !this->isAlive(station, currentMillis))
+                continue;
+
+            if (station.id == this->preferredStation_)
+                preferred = &station;
+            if (station.id == this->selectedStation_)
+                selected = &station;
+            if (best == nullptr || station.packets > best->packets)
+                best = &station;
+        }
+
+        // Prefers the preferred station, then sticks to the selected one.
+        if (preferred != nullptr)
+            this->selectedStation_ = preferred->id;
+        else if (selected != nullptr)
+            this->selectedStation_ = selected->id;
+        else
+            this->selectedStation_ = best != nullptr ? best->id : NoStation;
+
+        return this->selectedStation_;
+    }
+
+    /// @brief Checks whether the given station has been heard recently.
+    /// @param station the station.
+    /// @param currentMillis the current time.
+    /// @return true if the station is alive.
+    bool StationSelector::isAlive(const Station &station, uint32_t currentMillis) const noexcept
+    {
+        return currentMillis - station.lastHeardMillis < this->timeoutMillis_;
+    }
+}
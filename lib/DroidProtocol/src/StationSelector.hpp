@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::protocol
+{
+    /// @brief Selects the base station a rover takes its corrections from, when several
+    ///  base stations share the channel.
+    ///
+    /// The preferred station is used whenever it's heard. Otherwise the selected station
+    ///  is kept as long as it's heard, and replaced by the most heard station if it's lost.
+    class StationSelector
+    {
+    public:
+        /// @brief The number of stations that are tracked.
+        static constexpr uint8_t MaxStations = 4U;
+
+        /// @brief The station that is selected when none has been heard.
+        static constexpr uint8_t NoStation = 0xFFU;
+
+        /// @brief A tracked station.
+        struct Station
+        {
+        public:
+            uint32_t lastHeardMillis;
+            uint16_t packets;
+            uint8_t id;
+            bool used;
+        };
+
+    private:
+        Station stations_[MaxStations];
+        const uint32_t timeoutMillis_;
+        const uint8_t preferredStation_;
+        uint8_t selectedStation_;
+
+    public:
+        /// @brief Constructs a new station selector.
+        /// @param preferredStation the preferred station, or NoStation.
+        /// @param timeoutMillis the time after which a station that is not heard is lost.
+        StationSelector(uint8_t preferredStation, uint32_t timeoutMillis) noexcept;
+
+    public:
+        /// @brief Gets the selected station.
+        /// @return the selected station, or NoStation.
+        inline uint8_t getSelectedStation(void) const noexcept
+        {
+            return this->selectedStation_;
+        }
+
+        /// @brief Records a packet of the given station, and updates the selection.
+        /// @param station the station.
+        /// @param currentMillis the current time.
+        /// @return true if the packet is from the selected station.
+        bool heard(uint8_t station, uint32_t currentMillis) noexcept;
+
+        /// @brief Updates the selection, dropping the stations that are lost.
+        /// @param currentMillis the current time.
+        /// @return the selected station, or NoStation.
+        uint8_t select(uint32_t currentMillis) noexcept;
+
+    private:
+        /// @brief Checks whether the given station has been heard recently.
+        /// @param station the station.
+        /// @param currentMillis the current time.
+        /// @return true if the station is alive.
+        bool isAlive(const Station &station, uint32_t currentMillis) const noexcept;
+    };
+}
@@ -0,0 +1,168 @@
+// Receives the raw broadcast of the base stations, and writes the RTCM frames of the
+//  selected station to the GNSS receiver on Serial1.
+//
+// The base stations must broadcast raw (COM__RAW_BROADCAST enabled in their src/config.hpp),
+//  without it they only multicast through RF24Network, which this rover does not join. The
+//  radio settings must match the base station (RF24__CHANNEL and RF24__DATA_RATE), and so
+//  must the authentication (COM__AUTH_ENABLED and COM__AUTH_KEY). The rover follows the
+//  selected station when it announces a move to another channel.
+//
+// The rover sends no NACKs, a lost chunk costs the frame it belongs to, see the README.
+
+#include <RF24.h>
+#include <ChaskeyMac.hpp>
+#include <DroidProtocol.hpp>
+#include <StationSelector.hpp>
+#include <RTCMReassembler.hpp>
+
+using namespace lacar::droid_basestation;
+
+static constexpr uint8_t RadioCE = 6U;
+static constexpr uint8_t RadioCS = 5U;
+static constexpr uint8_t RadioChannel = 90U;
+
+/// @brief The time after which a station or the sequence of its chunks is given up.
+static constexpr uint32_t StationTimeout = 3000UL;
+
+/// @brief The time after the last channel announcement heard after which the rover moves
+///  anyway, in case it missed the last one (COM__CHANNEL_ANNOUNCE_INTERVAL and a margin).
+static constexpr uint32_t ChannelFollowTimeout = 1500UL;
+
+/// @brief The interval of the statistics on Serial.
+static constexpr uint32_t StatusInterval = 5000UL;
+
+#define RAW_ROVER_AUTHENTICATED 0
+
+#if RAW_ROVER_AUTHENTICATED
+static const uint32_t AuthKey[4] = {0x5F3C2A91UL, 0xB4E8D706UL, 0x19A7C35EUL, 0x7D06F2B8UL};
+
+static protocol::ChaskeyMac::Key s_Key;
+
+/// @brief The frames of the epoch being received, as large as the largest epoch buffer of
+///  a base station.
+static uint8_t s_Epoch[protocol::MaxEpochSize];
+#endif
+
+static RF24 s_Radio(RadioCE, RadioCS);
+static protocol::StationSelector s_Selector(protocol::StationSelector::NoStation, StationTimeout);
+static uint8_t s_Frame[rover::RTCMReassembler::MaxFrameSize];
+static uint32_t s_LastStatusMillis = 0UL;
+static uint8_t s_Channel = RadioChannel;
+static uint8_t s_NextChannel = RadioChannel;
+static uint32_t s_LastAnnouncedMillis = 0UL;
+
+/// @brief Writes a complete frame to the receiver.
+static void writeFrame(void *u, const uint8_t *frame, uint16_t frameSize)
+{
+    (void)u;
+
+    Serial1.write(frame, frameSize);
+}
+
+static rover::RTCMReassembler s_Reassembler(s_Frame, sizeof(s_Frame), writeFrame, StationTimeout, nullptr);
+
+/// @brief Follows the channel announcement of the selected station, which moves right after
+///  the announcement with countdown 0.
+static void handleChannel(const protocol::ChannelAnnouncement &announcement, uint32_t currentMillis)
+{
+    if (announcement.station != s_Selector.getSelectedStation() || announcement.channel == s_Channel)
+        return;
+
+    s_NextChannel = announcement.channel;
+    s_LastAnnouncedMillis = currentMillis;
+
+    if (announcement.countdown == 0U)
+    {
+        s_Channel = s_NextChannel;
+        s_Radio.setChannel(s_Channel);
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial1.begin(115200);
+
+    if (!s_Radio.begin())
+    {
+        Serial.println(F("RF24 begin failed"));
+        while (true)
+            ;
+    }
+
+    s_Radio.setChannel(RadioChannel);
+    s_Radio.setDataRate(RF24_250KBPS);
+    s_Radio.enableDynamicPayloads();
+    s_Radio.setAutoAck(false);
+    s_Radio.openReadingPipe(0U, protocol::RawBroadcastAddress);
+    s_Radio.startListening();
+
+#if RAW_ROVER_AUTHENTICATED
+    protocol::ChaskeyMac::expandKey(AuthKey, s_Key);
+    s_Reassembler.enableAuthentication(s_Key, s_Epoch, sizeof(s_Epoch));
+#endif
+}
+
+void loop()
+{
+    const uint32_t currentMillis = millis();
+
+    while (s_Radio.available())
+    {
+        uint8_t packet[protocol::RawPacketSize];
+        const uint8_t packetSize = s_Radio.getDynamicPayloadSize();
+        s_Radio.read(packet, packetSize);
+
+        protocol::RTCMStreamChunkHeader header;
+        protocol::ChannelAnnouncement announcement;
+        const uint8_t *chunk;
+        uint8_t chunkSize;
+
+        if (protocol::readRawChannelPacket(packet, packetSize, announcement))
+        {
+            handleChannel(announcement, currentMillis);
+            continue;
+        }
+
+        // Only the chunks of the selected station go to the receiver, the schedule
+        //  announcements are not used here.
+        if (!protocol::readRawChunkPacket(packet, packetSize, header, chunk, chunkSize) ||
+            !s_Selector.heard(header.station, currentMillis))
+            continue;
+
+        s_Reassembler.push(header, chunk, chunkSize, currentMillis);
+    }
+
+    s_Selector.select(currentMillis);
+
+    // Moves anyway once the announcements stopped, the last one was missed.
+    if (s_NextChannel != s_Channel && currentMillis - s_LastAnnouncedMillis >= ChannelFollowTimeout)
+    {
+        s_Channel = s_NextChannel;
+        s_Radio.setChannel(s_Channel);
+    }
+
+    if (currentMillis - s_LastStatusMillis >= StatusInterval)
+    {
+        const rover::RTCMReassembler::Statistics &statistics = s_Reassembler.getStatistics();
+
+        s_LastStatusMillis = currentMillis;
+
+        Serial.print(F("station="));
+        Serial.print(s_Selector.getSelectedStation());
+        Serial.print(F(" frames="));
+        Serial.print(statistics.frames);
+        Serial.print(F(" lost="));
+        Serial.print(statistics.lostChunks);
+        Serial.print(F(" invalid="));
+        Serial.print(statistics.invalidFrames);
+        Serial.print(F(" rejected="));
+        Serial.print(statistics.rejectedEpochs);
+        Serial.print(F(" markers="));
+        Serial.print(statistics.resolvedMarkers);
+        Serial.print(F("/"));
+        Serial.print(statistics.resolvedMarkers + statistics.unresolvedMarkers);
+        Serial.print(F(" age="));
+        Serial.println(s_Reassembler.getCorrectionAge(currentMillis));
+    }
+}
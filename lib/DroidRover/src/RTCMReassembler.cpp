@@ -0,0 +1,365 @@
+#include "RTCMReassembler.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::rover
+{
+    /// @brief Updates the CRC-24Q of RTCM with the given byte.
+    /// @param crc the current CRC.
+    /// @param byte the byte.
+    /// @return the new CRC.
+    static uint32_t updateCrc(uint32_t crc, uint8_t byte) noexcept
+    {
+        crc ^= static_cast<uint32_t>(byte) << 16;
+
+        for (uint8_t i = 0U; i < 8U; ++i)
+        {
+            crc <<= 1;
+
+            if ((crc & 0x1000000UL) != 0U)
+                crc ^= 0x1864CFBUL;
+        }
+
+        return crc & 0xFFFFFFUL;
+    }
+
+    /// @brief Constructs a new reassembler.
+    /// @param frame the storage of the frame being received.
+    /// @param frameCapacity the size of the storage, larger frames are dropped.
+    /// @param frameCallback the callback called with every complete frame.
+    /// @param resyncMillis the time without chunks after which any sequence is accepted.
+    /// @param userData the user data passed to the callback.
+    RTCMReassembler::RTCMReassembler(uint8_t *frame, uint16_t frameCapacity, FrameCallback frameCallback,
+                                     uint32_t resyncMillis, void *userData) noexcept
+        : frame_(frame),
+          frameCapacity_(frameCapacity),
+          frameCallback_(frameCallback),
+          userData_(userData),
+          resyncMillis_(resyncMillis),
+          statistics_(),
+          lastChunkMillis_(0U),
+          lastFrameMillis_(0U),
+          received_(0U),
+          frameSize_(0U),
+          nextSequence_(0U),
+          station_(0U),
+          synchronized_(false),
+          hasFrame_(false),
+          key_(nullptr),
+          mac_(),
+          epoch_(nullptr),
+          epochCapacity_(0U),
+          epochSize_(0U),
+          epochStart_(false),
+          epochIntact_(false),
+          staticFrames_()
+    {
+    }
+
+    /// @brief Forgets the frame being received and the sequence, the next chunk is
+    ///  accepted from any station.
+    void RTCMReassembler::reset(void) noexcept
+    {
+        this->discard();
+        this->synchronized_ = false;
+
+        // The first chunk may be in the middle of an epoch, so its tag cannot be checked.
+        this->epochStart_ = false;
+        this->epochIntact_ = false;
+        this->epochSize_ = 0U;
+    }
+
+    /// @brief Only passes on the frames of epochs with a valid tag from now on.
+    /// @param key the expanded key, which must outlive the reassembler.
+    /// @param epoch the storage of the frames of the epoch being received.
+    /// @param epochCapacity the size of the storage, larger epochs are rejected.
+    void RTCMReassembler::enableAuthentication(const protocol::ChaskeyMac::Key &key, uint8_t *epoch,
+                                               uint16_t epochCapacity) noexcept
+    {
+        this->key_ = &key;
+        this->epoch_ = epoch;
+        this->epochCapacity_ = epochCapacity;
+        this->reset();
+    }
+
+    /// @brief Adds the given chunk to the stream.
+    /// @param header the header of the chunk.
+    /// @param chunk the data of the chunk.
+    /// @param chunkSize the size of the data.
+    /// @param currentMillis the current time.
+    /// @return false if the chunk was ignored.
+    bool RTCMReassembler::push(const protocol::RTCMStreamChunkHeader &header, const uint8_t *chunk, uint8_t chunkSize,
+                               uint32_t currentMillis) noexcept
+    {
+        // Starts over with another station, or after a silence in which the sequence
+        //  may have wrapped.
+        if (this->synchronized_ &&
+            (header.station != this->station_ || currentMillis - this->lastChunkMillis_ >= this->resyncMillis_))
+            this->reset();
+
+        if (!this->synchronized_)
+        {
+            this->station_ = header.station;
+            this->nextSequence_ = header.sequence;
+            this->synchronized_ = true;
+        }
+
+        const int16_t distance = static_cast<int16_t>(header.sequence - this->nextSequence_);
+
+        // Ignores the chunks we've already had, or given up on.
+        if (distance < 0)
+        {
+            ++this->statistics_.duplicates;
+            return false;
+        }
+
+        // Drops the frame the lost chunks were part of.
+        if (distance > 0)
+        {
+            ++this->statistics_.gaps;
+            this->statistics_.lostChunks += static_cast<uint16_t>(distance);
+            this->discard();
+
+            // An epoch that lost a chunk cannot be authenticated.
+            this->epochIntact_ = false;
+        }
+
+        this->nextSequence_ = header.sequence + 1U;
+        this->lastChunkMillis_ = currentMillis;
+        ++this->statistics_.chunks;
+
+        const bool epochEnd = (header.flags & protocol::ChunkFlagEpochEnd) != 0U;
+
+        if (this->key_ != nullptr)
+        {
+            // Starts the tag with the first chunk after an epoch end, the tag covers its
+            //  sequence number.
+            if (this->epochStart_)
+            {
+                protocol::beginEpochTag(this->mac_, *this->key_, header.station, header.sequence);
+                this->epochStart_ = false;
+                this->epochIntact_ = distance == 0;
+                this->epochSize_ = 0U;
+            }
+
+            // The tag takes the last bytes of the last chunk.
+            if (epochEnd)
+            {
+                if (chunkSize < protocol::EpochTagSize)
+                {
+                    this->epochIntact_ = false;
+                    chunkSize = protocol::EpochTagSize;
+                }
+
+                chunkSize -= protocol::EpochTagSize;
+            }
+
+            if (this->epochIntact_)
+                this->mac_.update(chunk, chunkSize);
+        }
+
+        for (uint8_t i = 0U; i < chunkSize; ++i)
+            this->pushByte(chunk[i], currentMillis);
+
+        // The next chunk starts with the first frame of the next epoch, so a frame that
+        //  is not complete by now never will be.
+        if (epochEnd)
+        {
+            if (this->received_ != 0U)
+            {
+                ++this->statistics_.invalidFrames;
+                this->discard();
+            }
+
+            if (this->key_ != nullptr)
+                this->finishEpoch(chunk + chunkSize, currentMillis);
+
+            ++this->statistics_.epochs;
+        }
+
+        return true;
+    }
+
+    /// @brief Adds the given byte to the frame being received.
+    /// @param byte the byte.
+    /// @param currentMillis the current time.
+    void RTCMReassembler::pushByte(uint8_t byte, uint32_t currentMillis) noexcept
+    {
+        // Skips everything up to the preamble, or that of a marker.
+        if (this->received_ == 0U && byte != Preamble && byte != protocol::StaticMarkerPreamble)
+        {
+            ++this->statistics_.discardedBytes;
+            return;
+        }
+
+        this->frame_[this->received_++] = byte;
+
+        if (this->frame_[0] == protocol::StaticMarkerPreamble)
+        {
+            if (this->received_ == sizeof(protocol::StaticMarker))
+                this->resolveMarker(currentMillis);
+
+            return;
+        }
+
+        // Takes the size from the length, the upper 6 bits are reserved and must be zero.
+        if (this->received_ == HeaderSize)
+        {
+            this->frameSize_ = HeaderSize + CrcSize +
+                               ((static_cast<uint16_t>(this->frame_[1] & 0x03U) << 8) | this->frame_[2]);
+
+            if ((this->frame_[1] & 0xFCU) != 0U || this->frameSize_ > this->frameCapacity_)
+            {
+                ++this->statistics_.invalidFrames;
+                this->discard();
+            }
+
+            return;
+        }
+
+        if (this->received_ < HeaderSize || this->received_ < this->frameSize_)
+            return;
+
+        // Checks the CRC over the header and the payload.
+        const uint16_t crcOffset = this->frameSize_ - CrcSize;
+        uint32_t crc = 0U;
+
+        for (uint16_t i = 0U; i < crcOffset; ++i)
+            crc = updateCrc(crc, this->frame_[i]);
+
+        const uint32_t receivedCrc = (static_cast<uint32_t>(this->frame_[crcOffset]) << 16) |
+                                     (static_cast<uint32_t>(this->frame_[crcOffset + 1U]) << 8) |
+                                     this->frame_[crcOffset + 2U];
+
+        if (crc != receivedCrc)
+        {
+            ++this->statistics_.invalidFrames;
+            this->discard();
+            return;
+        }
+
+        this->deliver(this->frameSize_, currentMillis);
+        this->received_ = 0U;
+    }
+
+    /// @brief Passes the given complete frame on, or holds it back until the tag of
+    ///  its epoch has been checked.
+    /// @param frameSize the size of the frame.
+    /// @param currentMillis the current time.
+    void RTCMReassembler::deliver(uint16_t frameSize, uint32_t currentMillis) noexcept
+    {
+        if (this->key_ == nullptr)
+        {
+            this->emit(this->frame_, frameSize, currentMillis);
+            return;
+        }
+
+        // Holds the frame back, an epoch that does not fit is rejected.
+        if (!this->epochIntact_ || this->epochSize_ + frameSize > this->epochCapacity_)
+        {
+            this->epochIntact_ = false;
+            return;
+        }
+
+        memcpy(this->epoch_ + this->epochSize_, this->frame_, frameSize);
+        this->epochSize_ += frameSize;
+    }
+
+    /// @brief Checks the tag at the end of the epoch, and passes its frames on if it is valid.
+    /// @param tag the received tag.
+    /// @param currentMillis the current time.
+    void RTCMReassembler::finishEpoch(const uint8_t *tag, uint32_t currentMillis) noexcept
+    {
+        const bool intact = this->epochIntact_;
+
+        this->epochStart_ = true;
+        this->epochIntact_ = false;
+
+        // The epoch was already given up on because of a lost chunk, or we started in the middle of it.
+        if (!intact)
+            return;
+
+        uint8_t expectedTag[protocol::EpochTagSize];
+        this->mac_.finish(expectedTag, sizeof(expectedTag));
+
+        if (memcmp(expectedTag, tag, sizeof(expectedTag)) != 0)
+        {
+            ++this->statistics_.rejectedEpochs;
+            return;
+        }
+
+        ++this->statistics_.authenticatedEpochs;
+
+        // Passes the held back frames on, one at a time.
+        uint16_t offset = 0U;
+        while (offset < this->epochSize_)
+        {
+            const uint8_t *frame = this->epoch_ + offset;
+            const uint16_t frameSize = HeaderSize + CrcSize + ((static_cast<uint16_t>(frame[1] & 0x03U) << 8) | frame[2]);
+
+            this->emit(frame, frameSize, currentMillis);
+            offset += frameSize;
+        }
+    }
+
+    /// @brief Replaces the marker in the frame being received by the static frame it
+    ///  refers to, and delivers it.
+    /// @param currentMillis the current time.
+    void RTCMReassembler::resolveMarker(uint32_t currentMillis) noexcept
+    {
+        protocol::StaticMarker marker;
+        memcpy(&marker, this->frame_, sizeof(marker));
+
+        const uint8_t index = protocol::getStaticMessageIndex(marker.messageNumber);
+
+        // The frame is matched on its CRC, so a marker of a frame we've not had (or an
+        //  older one) is dropped rather than resolved to the wrong frame.
+        if (index == protocol::NoStaticMessage || this->staticFrames_[index].size == 0U ||
+            memcmp(this->staticFrames_[index].data + this->staticFrames_[index].size - CrcSize, marker.crc, CrcSize) != 0)
+        {
+            ++this->statistics_.unresolvedMarkers;
+            this->discard();
+            return;
+        }
+
+        ++this->statistics_.resolvedMarkers;
+
+        const StaticFrame &staticFrame = this->staticFrames_[index];
+        memcpy(this->frame_, staticFrame.data, staticFrame.size);
+
+        this->received_ = 0U;
+        this->deliver(staticFrame.size, currentMillis);
+    }
+
+    /// @brief Passes the given frame on, and keeps it if it is static.
+    /// @param frame the frame.
+    /// @param frameSize the size of the frame.
+    /// @param currentMillis the current time.
+    void RTCMReassembler::emit(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) noexcept
+    {
+        ++this->statistics_.frames;
+        this->lastFrameMillis_ = currentMillis;
+        this->hasFrame_ = true;
+
+        // Only frames that are passed on are kept, so with authentication a marker is
+        //  never resolved from a frame of a rejected epoch.
+        if (frameSize >= HeaderSize + 2U + CrcSize && frameSize <= protocol::MaxStaticFrameSize)
+        {
+            const uint8_t index = protocol::getStaticMessageIndex(protocol::getFrameMessageNumber(frame));
+
+            if (index != protocol::NoStaticMessage)
+            {
+                memcpy(this->staticFrames_[index].data, frame, frameSize);
+                this->staticFrames_[index].size = static_cast<uint8_t>(frameSize);
+            }
+        }
+
+        this->frameCallback_(this->userData_, frame, frameSize);
+    }
+
+    /// @brief Drops the frame being received.
+    void RTCMReassembler::discard(void) noexcept
+    {
+        this->statistics_.discardedBytes += this->received_;
+        this->received_ = 0U;
+    }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <stdint.h>
+#include <ChaskeyMac.hpp>
+#include <DroidProtocol.hpp>
+
+namespace lacar::droid_basestation::rover
+{
+    /// @brief Reassembles the RTCM frames from the stream chunks of a base station, and
+    ///  passes every frame with a valid CRC on as soon as it is complete.
+    ///
+    /// Only the frame being received is buffered. A lost chunk drops that frame, the
+    ///  reassembler then looks for the next preamble, and starts clean at the next epoch
+    ///  since every epoch starts with a frame. Chunks older than the next expected one
+    ///  (duplicates, relays and repairs) are ignored.
+    ///
+    /// With authentication, the frames of an epoch are held back until its tag at the end
+    ///  of the last chunk has been checked, which delays them by the burst of the epoch.
+    ///
+    /// The last 1005 and 1230 frames passed on are kept, and a marker of an unchanged
+    ///  static frame is resolved from them. Until the first full frame arrives (at most
+    ///  the refresh interval of the base station), the markers are dropped.
+    class RTCMReassembler
+    {
+    public:
+        /// @brief Called with every complete frame.
+        typedef void (*FrameCallback)(void *, const uint8_t *, uint16_t);
+
+        /// @brief The preamble of every RTCM frame.
+        static constexpr uint8_t Preamble = 0xD3;
+
+        /// @brief The size of the preamble and the length.
+        static constexpr uint8_t HeaderSize = 3U;
+
+        /// @brief The size of the CRC.
+        static constexpr uint8_t CrcSize = 3U;
+
+        /// @brief The size of the largest frame.
+        static constexpr uint16_t MaxFrameSize = HeaderSize + 1023U + CrcSize;
+
+        /// @brief The age returned before the first frame.
+        static constexpr uint32_t NoCorrection = 0xFFFFFFFFUL;
+
+        /// @brief The counters of the reassembler.
+        struct Statistics
+        {
+        public:
+            uint32_t chunks;
+            uint32_t duplicates;
+            uint32_t lostChunks;
+            uint32_t gaps;
+            uint32_t frames;
+            uint32_t invalidFrames;
+            uint32_t discardedBytes;
+            uint32_t epochs;
+            uint32_t authenticatedEpochs;
+            uint32_t rejectedEpochs;
+            uint32_t resolvedMarkers;
+            uint32_t unresolvedMarkers;
+        };
+
+        /// @brief The last static frame of a message, a size of zero means none yet.
+        struct StaticFrame
+        {
+        public:
+            uint8_t size;
+            uint8_t data[protocol::MaxStaticFrameSize];
+        };
+
+    private:
+        uint8_t *const frame_;
+        const uint16_t frameCapacity_;
+        const FrameCallback frameCallback_;
+        void *const userData_;
+        const uint32_t resyncMillis_;
+        Statistics statistics_;
+        uint32_t lastChunkMillis_;
+        uint32_t lastFrameMillis_;
+        uint16_t received_;
+        uint16_t frameSize_;
+        uint16_t nextSequence_;
+        uint8_t station_;
+        bool synchronized_;
+        bool hasFrame_;
+        const protocol::ChaskeyMac::Key *key_;
+        protocol::ChaskeyMac mac_;
+        uint8_t *epoch_;
+        uint16_t epochCapacity_;
+        uint16_t epochSize_;
+        bool epochStart_;
+        bool epochIntact_;
+        StaticFrame staticFrames_[protocol::StaticMessageCount];
+
+    public:
+        /// @brief Constructs a new reassembler.
+        /// @param frame the storage of the frame being received.
+        /// @param frameCapacity the size of the storage, larger frames are dropped.
+        /// @param frameCallback the callback called with every complete frame.
+        /// @param resyncMillis the time without chunks after which any sequence is accepted.
+        /// @param userData the user data passed to the callback.
+        RTCMReassembler(uint8_t *frame, uint16_t frameCapacity, FrameCallback frameCallback,
+                        uint32_t resyncMillis, void *userData) noexcept;
+
+    public:
+        /// @brief Gets the counters of the reassembler.
+        /// @return the statistics.
+        inline const Statistics &getStatistics(void) const noexcept
+        {
+            return this->statistics_;
+        }
+
+        /// @brief Gets the station the chunks are taken from.
+        /// @return the station, only valid once a chunk has been accepted.
+        inline uint8_t getStation(void) const noexcept
+        {
+            return this->station_;
+        }
+
+        /// @brief Gets the time since the last complete frame.
+        /// @param currentMillis the current time.
+        /// @return the age of the corrections, or NoCorrection.
+        inline uint32_t getCorrectionAge(uint32_t currentMillis) const noexcept
+        {
+            return this->hasFrame_ ? currentMillis - this->lastFrameMillis_ : NoCorrection;
+        }
+
+        /// @brief Forgets the frame being received and the sequence, the next chunk is
+        ///  accepted from any station.
+        void reset(void) noexcept;
+
+        /// @brief Only passes on the frames of epochs with a valid tag from now on.
+        /// @param key the expanded key, which must outlive the reassembler.
+        /// @param epoch the storage of the frames of the epoch being received.
+        /// @param epochCapacity the size of the storage, larger epochs are rejected.
+        void enableAuthentication(const protocol::ChaskeyMac::Key &key, uint8_t *epoch, uint16_t epochCapacity) noexcept;
+
+        /// @brief Adds the given chunk to the stream.
+        /// @param header the header of the chunk.
+        /// @param chunk the data of the chunk.
+        /// @param chunkSize the size of the data.
+        /// @param currentMillis the current time.
+        /// @return false if the chunk was ignored.
+        bool push(const protocol::RTCMStreamChunkHeader &header, const uint8_t *chunk, uint8_t chunkSize,
+                  uint32_t currentMillis) noexcept;
+
+    private:
+        /// @brief Adds the given byte to the frame being received.
+        /// @param byte the byte.
+        /// @param currentMillis the current time.
+        void pushByte(uint8_t byte, uint32_t currentMillis) noexcept;
+
+        /// @brief Passes the given complete frame on, or holds it back until the tag of
+        ///  its epoch has been checked.
+        /// @param frameSize the size of the frame.
+        /// @param currentMillis the current time.
+        void deliver(uint16_t frameSize, uint32_t currentMillis) noexcept;
+
+        /// @brief Replaces the marker in the frame being received by the static frame it
+        ///  refers to, and delivers it.
+        /// @param currentMillis the current time.
+        void resolveMarker(uint32_t currentMillis) noexcept;
+
+        /// @brief Passes the given frame on, and keeps it if it is static.
+        /// @param frame the frame.
+        /// @param frameSize the size of the frame.
+        /// @param currentMillis the current time.
+        void emit(const uint8_t *frame, uint16_t frameSize, uint32_t currentMillis) noexcept;
+
+        /// @brief Checks the tag at the end of the epoch, and passes its frames on if it is valid.
+        /// @param tag the received tag.
+        /// @param currentMillis the current time.
+        void finishEpoch(const uint8_t *tag, uint32_t currentMillis) noexcept;
+
+        /// @brief Drops the frame being received.
+        void discard(void) noexcept;
+    };
+}
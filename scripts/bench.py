@@ -0,0 +1,49 @@
+# Adds the `bench` target to the native bench environment, which runs the host
+#  microbenchmarks of the RTCM hot path and compares them against the stored baseline.
+#
+#   pio run -e bench -t bench
+#   BENCH_CAPTURE=capture.rtcm pio run -e bench -t bench
+#   BENCH_UPDATE_BASELINE=1 pio run -e bench -t bench
+
+import os
+import shutil
+import subprocess
+import sys
+
+Import("env")
+
+BASELINE = os.path.join(env.subst("$PROJECT_DIR"), "bench", "baseline.json")
+
+
+def bench(source, target, env):
+    program = str(source[0])
+    results = os.path.join(env.subst("$BUILD_DIR"), "bench.json")
+
+    # Starts the log benchmark with an empty directory.
+    log_directory = os.path.join(env.subst("$BUILD_DIR"), "bench_log")
+    shutil.rmtree(log_directory, ignore_errors=True)
+
+    command = [program, "--json", results, "--log-dir", log_directory]
+    if os.environ.get("BENCH_CAPTURE"):
+        command += ["--capture", os.environ["BENCH_CAPTURE"]]
+
+    if subprocess.call(command) != 0:
+        env.Exit(1)
+
+    if os.environ.get("BENCH_UPDATE_BASELINE"):
+        shutil.copyfile(results, BASELINE)
+        print("Updated %s" % BASELINE)
+        return
+
+    compare = os.path.join(env.subst("$PROJECT_DIR"), "scripts", "bench_compare.py")
+    if subprocess.call([sys.executable, compare, BASELINE, results]) != 0:
+        env.Exit(1)
+
+
+env.AddCustomTarget(
+    name="bench",
+    dependencies="$BUILD_DIR/${PROGNAME}",
+    actions=[bench],
+    title="Bench",
+    description="Runs the RTCM hot path microbenchmarks and compares them against the baseline",
+)
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Compares the results of the RTCM hot path microbenchmarks against a baseline, and
+#  fails when a benchmark regressed by more than the tolerance. It also fails when the
+#  capture or the set of benchmarks differs from the baseline, which must then be
+#  regenerated (BENCH_UPDATE_BASELINE=1 pio run -e bench -t bench) in the change
+#  that caused it.
+#
+#   python scripts/bench_compare.py bench/baseline.json results.json [--tolerance 0.15]
+
+import argparse
+import json
+import sys
+
+# The metrics where lower is better, the packet rate is derived from the time per packet.
+METRICS = ("ns_per_byte", "ns_per_packet")
+
+
+def load(path):
+    with open(path) as file:
+        data = json.load(file)
+
+    return data["capture_bytes"], {benchmark["name"]: benchmark for benchmark in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("results")
+    parser.add_argument("--tolerance", type=float, default=0.15,
+                        help="the allowed relative slowdown (default: 0.15)")
+    args = parser.parse_args()
+
+    baselineCapture, baseline = load(args.baseline)
+    resultsCapture, results = load(args.results)
+    regressions = 0
+    mismatches = 0
+
+    # The times per byte are only comparable over the same capture.
+    if baselineCapture != resultsCapture:
+        print("capture_bytes %d in the baseline, %d in the results" % (baselineCapture, resultsCapture))
+        mismatches += 1
+
+    for name in sorted(set(baseline) - set(results)):
+        print("%-24s (missing from the results)" % name)
+        mismatches += 1
+
+    for name, result in sorted(results.items()):
+        if name not in baseline:
+            print("%-24s (missing from the baseline)" % name)
+            mismatches += 1
+            continue
+
+        for metric in METRICS:
+            old, new = baseline[name][metric], result[metric]
+            if old <= 0.0:
+                continue
+
+            change = (new - old) / old
+            regressed = change > args.tolerance
+            regressions += regressed
+
+            print("%-24s %-14s %10.2f -> %10.2f  %+6.1f%%%s" % (
+                name, metric, old, new, change * 100.0, "  REGRESSION" if regressed else ""))
+
+    if mismatches:
+        print("\nThe results do not match the baseline, regenerate it")
+        return 1
+
+    if regressions:
+        print("\n%d metric(s) regressed by more than %.0f%%" % (regressions, args.tolerance * 100.0))
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,61 @@
+# Adds the `ramreport` target, which prints the section sizes of the firmware
+#  and the largest symbols in RAM (.data and .bss), grouped per module.
+#
+#   pio run -e basestation -t ramreport
+#   pio run -e basestation_stm32 -t ramreport
+
+import os
+import subprocess
+from collections import defaultdict
+
+Import("env")
+
+
+def tool(name):
+    # Derives the binutils tool from the size tool of the toolchain (avr-size -> avr-nm, arm-none-eabi-size -> arm-none-eabi-nm).
+    size = env.subst("$SIZETOOL")
+    return os.path.join(os.path.dirname(size), os.path.basename(size).replace("size", name))
+
+
+def ram_report(source, target, env):
+    elf = str(source[0])
+
+    subprocess.call([tool("size"), "-A", "-d", elf])
+
+    output = subprocess.check_output([tool("nm"), "-C", "-S", "--size-sort", "--radix=d", elf],
+                                     universal_newlines=True)
+
+    modules = defaultdict(int)
+    symbols = []
+
+    for line in output.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) != 4 or parts[2] not in "bBdD":
+            continue
+
+        size, name = int(parts[1]), parts[3]
+        symbols.append((size, name))
+
+        # Groups the symbols of the firmware by their class, the rest by their prefix.
+        if "::firmware::" in name:
+            module = name.split("::firmware::")[1].split("::")[0]
+        else:
+            module = name.split("::")[0] if "::" in name else "(other)"
+        modules[module] += size
+
+    print("\nRAM per module:")
+    for module, size in sorted(modules.items(), key=lambda item: -item[1]):
+        print("  %6d  %s" % (size, module))
+
+    print("\nLargest RAM symbols:")
+    for size, name in sorted(symbols, reverse=True)[:20]:
+        print("  %6d  %s" % (size, name))
+
+
+env.AddCustomTarget(
+    name="ramreport",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[ram_report],
+    title="RAM Report",
+    description="Prints the static RAM usage per module",
+)
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# Extracts the raw RTCM stream from the log files of the base station, for post-processing
+#  (e.g. with RTKLIB), optionally with the time of every frame.
+#
+#   python scripts/rtcm_log_extract.py /media/sd output.rtcm [--times output.csv]
+
+import argparse
+import os
+import struct
+import sys
+
+RECORD_MARKER = 0xA5
+RECORD_HEADER = struct.Struct("<BIH")
+
+
+def log_files(directory):
+    # The files continue each other, so they're read in the order of their index.
+    names = sorted(name for name in os.listdir(directory)
+                   if name.upper().startswith("RTCM") and name.upper().endswith(".LOG"))
+    return [os.path.join(directory, name) for name in names]
+
+
+def records(data):
+    offset = 0
+    while offset + RECORD_HEADER.size <= len(data):
+        # Skips the padding of blocks that were written before they were full.
+        if data[offset] != RECORD_MARKER:
+            offset += 1
+            continue
+
+        _, millis, size = RECORD_HEADER.unpack_from(data, offset)
+        end = offset + RECORD_HEADER.size + size
+        if end > len(data):
+            break
+
+        yield millis, data[offset + RECORD_HEADER.size:end]
+        offset = end
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("directory")
+    parser.add_argument("output")
+    parser.add_argument("--times", help="writes the time and size of every frame as CSV")
+    args = parser.parse_args()
+
+    data = b"".join(open(path, "rb").read() for path in log_files(args.directory))
+
+    count = 0
+    with open(args.output, "wb") as output:
+        times = open(args.times, "w") if args.times else None
+        if times:
+            times.write("millis,message,size\n")
+
+        for millis, frame in records(data):
+            output.write(frame)
+            count += 1
+
+            if times and len(frame) >= 5:
+                times.write("%d,%d,%d\n" % (millis, (frame[3] << 4) | (frame[4] >> 4), len(frame)))
+
+        if times:
+            times.close()
+
+    print("Extracted %d frames" % count)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,47 @@
+#include "Backoff.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new backoff instance.
+    /// @param initialDelay the delay before the first attempt.
+    /// @param maxDelay the maximum delay between two attempts.
+    /// @param maxAttempts the number of attempts before giving up.
+    Backoff::Backoff(uint32_t initialDelay, uint32_t maxDelay, uint8_t maxAttempts) noexcept
+        : initialDelay_(initialDelay),
+          maxDelay_(maxDelay),
+          maxAttempts_(maxAttempts),
+          delay_(initialDelay),
+          sinceMillis_(0U),
+          attempts_(0U)
+    {
+    }
+
+    /// @brief Resets the attempts and the delay, called after a success.
+    void Backoff::reset(void) noexcept
+    {
+        this->delay_ = this->initialDelay_;
+        this->attempts_ = 0U;
+    }
+
+    /// @brief Starts waiting for the current delay.
+    /// @param currentMillis the current time.
+    void Backoff::start(uint32_t currentMillis) noexcept
+    {
+        this->sinceMillis_ = currentMillis;
+    }
+
+    /// @brief Checks whether the next attempt should be made.
+    /// @param currentMillis the current time.
+    /// @return true if the delay has elapsed and there are attempts left.
+    bool Backoff::isDue(uint32_t currentMillis) const noexcept
+    {
+        return !this->isExhausted() && currentMillis - this->sinceMillis_ >= this->delay_;
+    }
+
+    /// @brief Consumes an attempt and doubles the delay for the next one.
+    void Backoff::next(void) noexcept
+    {
+        ++this->attempts_;
+        this->delay_ = min(this->delay_ * 2U, this->maxDelay_);
+    }
+}
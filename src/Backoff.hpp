@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief An exponential backoff with a bounded number of attempts.
+    class Backoff
+    {
+    private:
+        const uint32_t initialDelay_;
+        const uint32_t maxDelay_;
+        const uint8_t maxAttempts_;
+        uint32_t delay_;
+        uint32_t sinceMillis_;
+        uint8_t attempts_;
+
+    public:
+        /// @brief Constructs a new backoff instance.
+        /// @param initialDelay the delay before the first attempt.
+        /// @param maxDelay the maximum delay between two attempts.
+        /// @param maxAttempts the number of attempts before giving up.
+        Backoff(uint32_t initialDelay, uint32_t maxDelay, uint8_t maxAttempts) noexcept;
+
+    public:
+        /// @brief Gets the number of attempts made since the last reset.
+        /// @return the number of attempts.
+        inline uint8_t getAttempts(void) const noexcept
+        {
+            return this->attempts_;
+        }
+
+        /// @brief Checks whether all attempts have been used.
+        /// @return true if the backoff has given up.
+        inline bool isExhausted(void) const noexcept
+        {
+            return this->attempts_ >= this->maxAttempts_;
+        }
+
+        /// @brief Resets the attempts and the delay, called after a success.
+        void reset(void) noexcept;
+
+        /// @brief Starts waiting for the current delay.
+        /// @param currentMillis the current time.
+        void start(uint32_t currentMillis) noexcept;
+
+        /// @brief Checks whether the next attempt should be made.
+        /// @param currentMillis the current time.
+        /// @return true if the delay has elapsed and there are attempts left.
+        bool isDue(uint32_t currentMillis) const noexcept;
+
+        /// @brief Consumes an attempt and doubles the delay for the next one.
+        void next(void) noexcept;
+    };
+}
@@ -0,0 +1,94 @@
+#include "ChannelSurvey.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new survey of the candidate channels.
+    ChannelSurvey::ChannelSurvey(void) noexcept
+        : candidates_(),
+          index_(0U)
+    {
+        for (uint8_t i = 0U; i < CandidateCount; ++i)
+            this->candidates_[i].channel = static_cast<uint8_t>(LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_FIRST +
+                                                                i * LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_STEP);
+    }
+
+    /// @brief Forgets the samples and starts at the first candidate.
+    void ChannelSurvey::reset(void) noexcept
+    {
+        for (Candidate &candidate : this->candidates_)
+        {
+            candidate.busySamples = 0U;
+            candidate.samples = 0U;
+        }
+
+        this->index_ = 0U;
+    }
+
+    /// @brief Records the samples of the current channel, and moves on to the next one.
+    /// @param busySamples the number of samples that saw a carrier.
+    /// @param samples the number of samples.
+    void ChannelSurvey::record(uint8_t busySamples, uint8_t samples) noexcept
+    {
+        Candidate &candidate = this->candidates_[this->index_];
+
+        candidate.busySamples += busySamples;
+        candidate.samples += samples;
+
+        this->index_ = static_cast<uint8_t>((this->index_ + 1U) % CandidateCount);
+    }
+
+    /// @brief Gets the occupancy of the given candidate.
+    /// @param index the index of the candidate.
+    /// @return the percentage of samples that saw a carrier.
+    uint8_t ChannelSurvey::getOccupancy(uint8_t index) const noexcept
+    {
+        const Candidate &candidate = this->candidates_[index];
+
+        // A channel that was never sampled is taken as fully occupied.
+        if (candidate.samples == 0U)
+            return 100U;
+
+        return static_cast<uint8_t>((static_cast<uint32_t>(candidate.busySamples) * 100UL) / candidate.samples);
+    }
+
+    /// @brief Finds the candidate of the given channel.
+    /// @param channel the channel.
+    /// @return the index of the candidate, or NoCandidate.
+    uint8_t ChannelSurvey::find(uint8_t channel) const noexcept
+    {
+        for (uint8_t i = 0U; i < CandidateCount; ++i)
+        {
+            if (this->candidates_[i].channel == channel)
+                return i;
+        }
+
+        return NoCandidate;
+    }
+
+    /// @brief Picks the least occupied channel, the current channel is kept unless
+    ///  another one is better by more than the margin.
+    /// @param currentChannel the channel in use.
+    /// @param margin the occupancy percentage another channel must be better by.
+    /// @return the channel to use.
+    uint8_t ChannelSurvey::pick(uint8_t currentChannel, uint8_t margin) const noexcept
+    {
+        uint8_t best = 0U;
+
+        for (uint8_t i = 1U; i < CandidateCount; ++i)
+        {
+            if (this->getOccupancy(i) < this->getOccupancy(best))
+                best = i;
+        }
+
+        // A channel outside of the candidates is always left for the best one.
+        const uint8_t current = this->find(currentChannel);
+        if (current == NoCandidate)
+            return this->candidates_[best].channel;
+
+        // Stays on the current channel unless the best one is clearly better.
+        if (static_cast<uint16_t>(this->getOccupancy(best)) + margin >= this->getOccupancy(current))
+            return currentChannel;
+
+        return this->candidates_[best].channel;
+    }
+}
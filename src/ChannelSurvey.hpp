@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Scores the candidate radio channels by how often the received power detector
+    ///  saw a carrier on them, sampled round-robin in short bursts.
+    class ChannelSurvey
+    {
+    public:
+        /// @brief The number of candidate channels.
+        static constexpr uint8_t CandidateCount =
+            (LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_LAST - LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_FIRST) /
+                LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_STEP +
+            1U;
+
+        /// @brief The index that refers to no candidate.
+        static constexpr uint8_t NoCandidate = 0xFFU;
+
+        /// @brief A candidate channel and its samples.
+        struct Candidate
+        {
+        public:
+            uint16_t busySamples;
+            uint16_t samples;
+            uint8_t channel;
+        };
+
+    private:
+        Candidate candidates_[CandidateCount];
+        uint8_t index_;
+
+    public:
+        /// @brief Constructs a new survey of the candidate channels.
+        ChannelSurvey(void) noexcept;
+
+    public:
+        /// @brief Gets the candidate at the given index.
+        /// @param index the index of the candidate.
+        /// @return the candidate.
+        inline const Candidate &getCandidate(uint8_t index) const noexcept
+        {
+            return this->candidates_[index];
+        }
+
+        /// @brief Gets the channel that should be sampled next.
+        /// @return the channel.
+        inline uint8_t getChannel(void) const noexcept
+        {
+            return this->candidates_[this->index_].channel;
+        }
+
+        /// @brief Gets whether every candidate has the given number of samples.
+        /// @param samples the number of samples.
+        /// @return true if the survey is complete.
+        inline bool isComplete(uint16_t samples) const noexcept
+        {
+            // The candidates are sampled in turn, so the last one has the fewest samples.
+            return this->candidates_[CandidateCount - 1U].samples >= samples;
+        }
+
+        /// @brief Forgets the samples and starts at the first candidate.
+        void reset(void) noexcept;
+
+        /// @brief Records the samples of the current channel, and moves on to the next one.
+        /// @param busySamples the number of samples that saw a carrier.
+        /// @param samples the number of samples.
+        void record(uint8_t busySamples, uint8_t samples) noexcept;
+
+        /// @brief Gets the occupancy of the given candidate.
+        /// @param index the index of the candidate.
+        /// @return the percentage of samples that saw a carrier.
+        uint8_t getOccupancy(uint8_t index) const noexcept;
+
+        /// @brief Finds the candidate of the given channel.
+        /// @param channel the channel.
+        /// @return the index of the candidate, or NoCandidate.
+        uint8_t find(uint8_t channel) const noexcept;
+
+        /// @brief Picks the least occupied channel, the current channel is kept unless
+        ///  another one is better by more than the margin.
+        /// @param currentChannel the channel in use.
+        /// @param margin the occupancy percentage another channel must be better by.
+        /// @return the channel to use.
+        uint8_t pick(uint8_t currentChannel, uint8_t margin) const noexcept;
+    };
+}
@@ -0,0 +1,93 @@
+#if !defined(ARDUINO)
+
+#include "HostLogStorage.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new host storage.
+    /// @param directory the directory the files are written to.
+    HostLogStorage::HostLogStorage(const char *directory) noexcept
+        : directory_(directory),
+          file_(nullptr)
+    {
+    }
+
+    HostLogStorage::~HostLogStorage(void) noexcept
+    {
+        this->close();
+    }
+
+    /// @brief Builds the path of the given file in the directory.
+    void HostLogStorage::getPath(char *path, size_t pathSize, const char *name) const noexcept
+    {
+        snprintf(path, pathSize, "%s/%s", this->directory_, name);
+    }
+
+    /// @brief Creates the directory if it does not exist yet.
+    bool HostLogStorage::begin(void) noexcept
+    {
+        struct stat info;
+        return stat(this->directory_, &info) == 0 ? S_ISDIR(info.st_mode) : mkdir(this->directory_, 0755) == 0;
+    }
+
+    /// @brief Checks whether a file with the given name exists.
+    bool HostLogStorage::exists(const char *name) noexcept
+    {
+        char path[256];
+        this->getPath(path, sizeof(path), name);
+        return access(path, F_OK) == 0;
+    }
+
+    /// @brief Creates the given file, or opens it for appending if it exists, as the log file.
+    bool HostLogStorage::open(const char *name) noexcept
+    {
+        char path[256];
+        this->getPath(path, sizeof(path), name);
+
+        this->close();
+        this->file_ = fopen(path, "ab");
+        return this->file_ != nullptr;
+    }
+
+    /// @brief Appends the given data to the log file.
+    bool HostLogStorage::write(const uint8_t *data, uint16_t size) noexcept
+    {
+        return this->file_ != nullptr && fwrite(data, 1U, size, this->file_) == size;
+    }
+
+    /// @brief Commits the written data to the file.
+    bool HostLogStorage::sync(void) noexcept
+    {
+        return this->file_ != nullptr && fflush(this->file_) == 0;
+    }
+
+    /// @brief Closes the log file.
+    void HostLogStorage::close(void) noexcept
+    {
+        if (this->file_ == nullptr)
+            return;
+
+        fclose(this->file_);
+        this->file_ = nullptr;
+    }
+
+    /// @brief Appends the given data to another file, opening and closing it again.
+    bool HostLogStorage::append(const char *name, const uint8_t *data, uint16_t size) noexcept
+    {
+        char path[256];
+        this->getPath(path, sizeof(path), name);
+
+        FILE *file = fopen(path, "ab");
+        if (file == nullptr)
+            return false;
+
+        const bool written = fwrite(data, 1U, size, file) == size;
+        fclose(file);
+
+        return written;
+    }
+}
+
+#endif
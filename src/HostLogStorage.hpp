@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdio.h>
+#include "RTCMLogStorage.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The RTCM log storage in a directory on the host, the stand-in for the SD card in
+    ///  the host builds.
+    class HostLogStorage : public RTCMLogStorage
+    {
+    private:
+        const char *const directory_;
+        FILE *file_;
+
+    public:
+        /// @brief Constructs a new host storage.
+        /// @param directory the directory the files are written to.
+        HostLogStorage(const char *directory) noexcept;
+
+        ~HostLogStorage(void) noexcept;
+
+    private:
+        /// @brief Builds the path of the given file in the directory.
+        void getPath(char *path, size_t pathSize, const char *name) const noexcept;
+
+    public:
+        bool begin(void) noexcept override;
+        bool exists(const char *name) noexcept override;
+        bool open(const char *name) noexcept override;
+        bool write(const uint8_t *data, uint16_t size) noexcept override;
+        bool sync(void) noexcept override;
+        void close(void) noexcept override;
+        bool append(const char *name, const uint8_t *data, uint16_t size) noexcept override;
+    };
+}
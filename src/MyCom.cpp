@@ -1,15 +1,157 @@
 #include "MyCom.hpp"
 #include "config.hpp"
+#include "MyEvents.hpp"
+#include "MyGPS.hpp"
+#include "MySchedule.hpp"
+#include "MyProfiler.hpp"
+#include "MyConsole.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
+    /// @brief Constructs an empty error state data instance.
+    MyCom::ErrorStateData::ErrorStateData(void) noexcept
+        : backoff(LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__INITIAL_DELAY,
+                  LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_DELAY,
+                  LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_ATTEMPTS)
+    {
+    }
+
     MyCom MyCom::s_Instance;
 
+    /// @brief The sink that writes the flushed epochs to the radio.
+    bool MyCom::staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept
+    {
+        MyCom &com = *static_cast<MyCom *>(u);
+
+        // Writes the epoch as one burst.
+        com.writeRTCMEpoch(epoch, epochSize, frame);
+
+        return com.state_ == State::Running;
+    }
+
+    /// @brief The capacity of the radio sink, nothing while the com is not running.
+    uint16_t MyCom::staticEpochCapacity(void *u) noexcept
+    {
+        return static_cast<MyCom *>(u)->state_ == State::Running ? UINT16_MAX : 0U;
+    }
+
+    /// @brief The command that prints the channel and the occupancy of the candidates.
+    void MyCom::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+
+        const MyCom &com = *static_cast<MyCom *>(u);
+        const ChannelData &channelData = com.channelData_;
+
+        Serial.print(F("CHAN channel="));
+        Serial.print(channelData.channel);
+        Serial.print(F(" next="));
+        Serial.print(channelData.nextChannel);
+        Serial.print(F(" countdown="));
+        Serial.print(channelData.countdown);
+        Serial.print(F(" switches="));
+        Serial.println(channelData.switches);
+
+        for (uint8_t i = 0U; i < ChannelSurvey::CandidateCount; ++i)
+        {
+            const ChannelSurvey::Candidate &candidate = com.channelSurvey_.getCandidate(i);
+
+            Serial.print(F("CAND "));
+            Serial.print(candidate.channel);
+            Serial.print(F(" samples="));
+            Serial.print(candidate.samples);
+            Serial.print(F(" occupancy="));
+            Serial.print(com.channelSurvey_.getOccupancy(i));
+            Serial.println(F("%"));
+        }
+    }
+
+    /// @brief The command that prints the cost of the epoch tags.
+    void MyCom::staticHandleAuthCommand(void *u, const char *arguments) noexcept
+    {
+        (void)u;
+        (void)arguments;
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        const AuthStatistics &statistics = static_cast<MyCom *>(u)->authStatistics_;
+
+        Serial.print(F("AUTH epochs="));
+        Serial.print(statistics.epochs);
+        Serial.print(F(" bytes="));
+        Serial.print(statistics.bytes);
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED
+        // The cycles per byte include the fixed cost of every epoch, amortized over its bytes.
+        const MyProfiler::ZoneStatistics &zone = MyProfiler::getInstance().getZoneStatistics(MyProfiler::Zone::ComAuthenticate);
+        if (statistics.bytes > 0U)
+        {
+            Serial.print(F(" cycles/byte="));
+            Serial.print(static_cast<float>(zone.totalCycles) / statistics.bytes);
+        }
+#endif
+
+        Serial.println();
+#else
+        Serial.println(F("AUTH disabled"));
+#endif
+    }
+
+    /// @brief The command that prints the static frames sent in full and as a marker.
+    void MyCom::staticHandleStaticCommand(void *u, const char *arguments) noexcept
+    {
+        (void)u;
+        (void)arguments;
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__STATIC_DEDUP_ENABLED
+        const protocol::RTCMStaticCache::Statistics &statistics = static_cast<MyCom *>(u)->staticCache_.getStatistics();
+
+        Serial.print(F("STATIC sent="));
+        Serial.print(statistics.sent);
+        Serial.print(F(" suppressed="));
+        Serial.print(statistics.suppressed);
+        Serial.print(F(" saved="));
+        Serial.println(statistics.savedBytes);
+#else
+        Serial.println(F("STATIC disabled"));
+#endif
+    }
+
     /// @brief Constructs a new com instance.
     MyCom::MyCom(void) noexcept : peripheral_(LACAR_DROID_BASESTATION_FIRMWARE__RF24__CE, LACAR_DROID_BASESTATION_FIRMWARE__RF24__CS),
                                   network_(peripheral_),
-                                  errorCause_(ErrorCause::Ok)
+                                  runningStateData_(),
+                                  errorStateData_(),
+                                  deliveryStatistics_(),
+                                  repairData_(),
+                                  repairStatistics_(),
+                                  relaySources_(),
+                                  relayStatistics_(),
+                                  channelSurvey_(),
+                                  channelData_(),
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+                                  authKey_(),
+                                  epochTag_(),
+                                  epochMac_(),
+                                  authStatistics_(),
+#endif
+                                  staticCache_(LACAR_DROID_BASESTATION_FIRMWARE__COM__STATIC_REFRESH_INTERVAL),
+                                  nextSequence_(0U),
+                                  recoveryCounts_(),
+                                  errorCause_(ErrorCause::Ok),
+                                  enabled_(false),
+                                  broadcasting_(false)
     {
+        for (RepairCacheEntry &entry : this->repairData_.entries)
+            entry.frame = RTCMFramePool::NoBlock;
+
+        this->channelData_.channel = LACAR_DROID_BASESTATION_FIRMWARE__RF24__CHANNEL;
+        this->channelData_.nextChannel = LACAR_DROID_BASESTATION_FIRMWARE__RF24__CHANNEL;
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        // Derives the subkeys once, instead of for every epoch.
+        const uint32_t key[4] = {LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_KEY};
+        protocol::ChaskeyMac::expandKey(key, this->authKey_);
+#endif
     }
 
     // Idle state methods.
@@ -34,6 +176,14 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the running state.
     void MyCom::runningEntry(void) noexcept
     {
+        // We're running again, so the next error gets the full retry budget.
+        this->errorStateData_.backoff.reset();
+
+        // Starts a new throughput interval.
+        this->runningStateData_.throughputSinceMillis = millis();
+        this->runningStateData_.throughputBytes = 0U;
+        this->runningStateData_.throughputChunks = 0U;
+        this->runningStateData_.consecutiveDrops = 0U;
     }
 
     /// @brief Do of the running state.
@@ -43,6 +193,9 @@ namespace lacar::droid_basestation::firmware
         uint8_t message[128];
         uint16_t messageSize;
 
+        // Returns to listening in case a raw burst was left unfinished.
+        this->finishBroadcast();
+
         // Updates the network.
         network_.update();
 
@@ -55,15 +208,390 @@ namespace lacar::droid_basestation::firmware
             // Checks the message type and calls the appropriate method.
             switch (static_cast<PacketType>(header.type))
             {
+            case PacketType::RTCMStreamChunk:
+                this->runningHandleChunk(header, message, messageSize);
+                break;
+            case PacketType::Nack:
+                this->runningHandleNack(message, messageSize);
+                break;
+            case PacketType::Schedule:
+                if (messageSize >= sizeof(ScheduleAnnouncement))
+                    MySchedule::getInstance().handleAnnouncement(*reinterpret_cast<const ScheduleAnnouncement *>(message));
+                break;
+            case PacketType::Channel:
+                this->runningHandleChannel(message, messageSize);
+                break;
             default:
                 break;
             }
         }
+
+        // Announces the schedule and sends the repairs requested by the rovers.
+        this->runningAnnounceSchedule();
+        this->runningSendRepairs();
+
+        // Announces a pending channel switch, and looks for a better channel in the meantime.
+        this->runningAnnounceChannel();
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SURVEY_ENABLED
+        this->runningSurveyChannels();
+#endif
+
+        // Publishes the throughput if needed.
+        this->runningPublishThroughput();
     }
 
     /// @brief Exit of the running state.
     void MyCom::runningExit(void) noexcept
     {
+        // Forgets the pending repairs, they're stale by the time we're running again.
+        this->repairData_.pendingMask = 0U;
+
+        this->finishBroadcast();
+    }
+
+    /// @brief Announces the TDMA schedule at the start of the first correction slot of a frame.
+    void MyCom::runningAnnounceSchedule(void) noexcept
+    {
+        MySchedule &schedule = MySchedule::getInstance();
+        MySchedule::Position position;
+
+        schedule.getPosition(micros(), position);
+
+        // Only announces once per frame, in a correction slot of a synchronized schedule.
+        if (!position.synchronized || position.frame == this->runningStateData_.lastAnnouncedFrame ||
+            !schedule.isCorrectionSlot(position.slot))
+            return;
+
+        this->runningStateData_.lastAnnouncedFrame = position.frame;
+
+        ScheduleAnnouncement announcement;
+        schedule.getAnnouncement(announcement);
+
+        this->announce(PacketType::Schedule, &announcement, sizeof(announcement));
+    }
+
+    /// @brief Samples the next candidate channel in a short burst while we're not expected
+    ///  to send or listen, and picks the channel once every candidate has been sampled.
+    void MyCom::runningSurveyChannels(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+        ChannelData &channelData = this->channelData_;
+        MySchedule &schedule = MySchedule::getInstance();
+        MySchedule::Position position;
+
+        // Doesn't look while a switch is pending, or until the next survey is due.
+        if (channelData.countdown != 0U ||
+            currentMillis - channelData.surveySinceMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SURVEY_INTERVAL ||
+            currentMillis - channelData.lastSampleMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SAMPLE_INTERVAL)
+            return;
+
+        // Only leaves the channel with nothing to send or repair, and outside of our correction
+        //  slots and the uplink slots of the rovers.
+        schedule.getPosition(micros(), position);
+        if (!MyGPS::getInstance().isEpochBufferEmpty() || this->repairData_.pendingMask != 0U ||
+            (position.synchronized && (schedule.isCorrectionSlot(position.slot) || schedule.isUplinkSlot(position.slot))))
+            return;
+
+        channelData.lastSampleMillis = currentMillis;
+
+        const uint8_t busySamples = this->sampleChannel(this->channelSurvey_.getChannel(),
+                                                        LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_BURST_SAMPLES);
+        this->channelSurvey_.record(busySamples, LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_BURST_SAMPLES);
+
+        if (!this->channelSurvey_.isComplete(LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_WINDOW_SAMPLES))
+            return;
+
+        // Announces the switch if another channel is clearly cleaner, and starts over.
+        const uint8_t channel = this->channelSurvey_.pick(channelData.channel,
+                                                          LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SWITCH_MARGIN);
+        if (channel != channelData.channel)
+        {
+            channelData.nextChannel = channel;
+            channelData.countdown = LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_ANNOUNCE_COUNT;
+        }
+
+        this->channelSurvey_.reset();
+        channelData.surveySinceMillis = currentMillis;
+    }
+
+    /// @brief Announces the pending switch to another channel, and switches after the
+    ///  last announcement.
+    void MyCom::runningAnnounceChannel(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+        ChannelData &channelData = this->channelData_;
+
+        // Announces once per interval, in a correction slot.
+        if (channelData.countdown == 0U ||
+            currentMillis - channelData.lastAnnouncedMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_ANNOUNCE_INTERVAL ||
+            !MySchedule::getInstance().isCorrectionSlot())
+            return;
+
+        channelData.lastAnnouncedMillis = currentMillis;
+
+        ChannelAnnouncement announcement;
+        announcement.station = LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID;
+        announcement.channel = channelData.nextChannel;
+        announcement.countdown = --channelData.countdown;
+
+        this->announce(PacketType::Channel, &announcement, sizeof(announcement));
+
+        if (channelData.countdown == 0U)
+            this->switchChannel(channelData.nextChannel);
+    }
+
+    /// @brief Follows the channel switch announced by another base station.
+    /// @param packet the announcement.
+    /// @param packetSize the size of the announcement.
+    void MyCom::runningHandleChannel(const uint8_t *packet, uint16_t packetSize) noexcept
+    {
+        if (packetSize < sizeof(ChannelAnnouncement))
+            return;
+
+        const ChannelAnnouncement &announcement = *reinterpret_cast<const ChannelAnnouncement *>(packet);
+
+        // Ignores our own announcements relayed back to us.
+        if (announcement.station == LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID ||
+            announcement.channel == this->channelData_.channel)
+            return;
+
+        // Switches with the announcing station, and passes the announcement on to our rovers
+        //  in the meantime.
+        if (announcement.countdown == 0U)
+        {
+            this->channelData_.countdown = 0U;
+            this->switchChannel(announcement.channel);
+            return;
+        }
+
+        this->channelData_.nextChannel = announcement.channel;
+        this->channelData_.countdown = announcement.countdown;
+    }
+
+    /// @brief Marks the chunks in the NACK of a rover for repair.
+    /// @param nack the NACK.
+    /// @param nackSize the size of the NACK.
+    void MyCom::runningHandleNack(const uint8_t *nack, uint16_t nackSize) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Ignores the NACKs meant for other base stations.
+        if (nackSize < sizeof(NackHeader) ||
+            reinterpret_cast<const NackHeader *>(nack)->station != LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID)
+            return;
+
+        const NackRange *ranges = reinterpret_cast<const NackRange *>(nack + sizeof(NackHeader));
+        const uint8_t rangeCount = static_cast<uint8_t>((nackSize - sizeof(NackHeader)) / sizeof(NackRange));
+
+        ++this->repairStatistics_.nacksReceived;
+
+        for (uint8_t i = 0U; i < rangeCount; ++i)
+        {
+            for (uint8_t j = 0U; j < ranges[i].count; ++j)
+            {
+                const uint16_t sequence = ranges[i].firstSequence + j;
+                const uint16_t age = this->nextSequence_ - sequence;
+
+                // Skips the chunks that are not sent yet, or no longer in the cache.
+                if (age == 0U || age > LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE)
+                {
+                    ++this->repairStatistics_.unavailable;
+                    continue;
+                }
+
+                const uint8_t slot = sequence % LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE;
+                const uint16_t slotMask = static_cast<uint16_t>(1U << slot);
+                const RepairCacheEntry &entry = this->repairData_.entries[slot];
+
+                // Skips the chunks whose epoch did not fit in the frame pool, and the markers
+                //  whose static frame changed since, which cannot be written again as sent.
+                if (entry.frame == RTCMFramePool::NoBlock &&
+                    (entry.markers == 0U || entry.markersGeneration != this->staticCache_.getGeneration()))
+                {
+                    ++this->repairStatistics_.unavailable;
+                    continue;
+                }
+
+                // Suppresses the repair if another rover already asked for it, or if
+                //  it has just been (re)sent and the rover may not have seen that yet.
+                if ((this->repairData_.pendingMask & slotMask) != 0U ||
+                    currentMillis - entry.lastSentMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_HOLDOFF)
+                {
+                    ++this->repairStatistics_.suppressed;
+                    continue;
+                }
+
+                // Starts the aggregation delay with the first pending repair.
+                if (this->repairData_.pendingMask == 0U)
+                    this->repairData_.pendingSinceMillis = currentMillis;
+
+                this->repairData_.pendingMask |= slotMask;
+            }
+        }
+    }
+
+    /// @brief Suppresses duplicates of a chunk from another station or relay, and relays it to
+    ///  the next level if there are nodes that need it.
+    /// @param header the network header of the chunk.
+    /// @param packet the chunk.
+    /// @param packetSize the size of the chunk.
+    void MyCom::runningHandleChunk(RF24NetworkHeader &header, const uint8_t *packet, uint16_t packetSize) noexcept
+    {
+        // Ignores packets too small to carry a chunk.
+        if (packetSize < sizeof(RTCMStreamChunkHeader))
+            return;
+
+        const RTCMStreamChunkHeader &chunkHeader = *reinterpret_cast<const RTCMStreamChunkHeader *>(packet);
+
+        ++this->relayStatistics_.received;
+
+        // Suppresses the chunks we've seen before. Repairs are exempt, the nodes
+        //  below us that asked for them have not seen them.
+        if (!this->getRelaySourceWindow(chunkHeader.station).accept(chunkHeader.sequence) &&
+            (chunkHeader.flags & protocol::ChunkFlagRepair) == 0U)
+        {
+            ++this->relayStatistics_.duplicates;
+            return;
+        }
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_ENABLED
+        // Only relays if there are levels below ours that have nodes on them.
+        if (LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_LEVEL >= LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_LAST_LEVEL)
+            return;
+
+        // Relays the chunk one level down, with the header of the source.
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComMulticast);
+        if (this->network_.multicast(header, packet, packetSize,
+                                     LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_LEVEL + 1U))
+            ++this->relayStatistics_.relayed;
+#else
+        (void)header;
+#endif
+    }
+
+    /// @brief Gets the sequence window of the given source station, replacing the least
+    ///  recently seen source if it is not known yet.
+    /// @param station the source station.
+    /// @return the sequence window.
+    SequenceWindow &MyCom::getRelaySourceWindow(uint8_t station) noexcept
+    {
+        const uint32_t currentMillis = millis();
+        RelaySource *oldest = &this->relaySources_[0];
+
+        for (uint8_t i = 0U; i < LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_MAX_SOURCES; ++i)
+        {
+            RelaySource &source = this->relaySources_[i];
+
+            // Returns the window of the source if we know it.
+            if (source.used && source.station == station)
+            {
+                source.lastSeenMillis = currentMillis;
+                return source.window;
+            }
+
+            // Keeps track of the source to replace, preferring unused ones.
+            if (!source.used || (oldest->used && currentMillis - source.lastSeenMillis > currentMillis - oldest->lastSeenMillis))
+                oldest = &source;
+        }
+
+        // Replaces the least recently seen source.
+        oldest->used = true;
+        oldest->station = station;
+        oldest->lastSeenMillis = currentMillis;
+        oldest->window.reset();
+
+        return oldest->window;
+    }
+
+    /// @brief Re-multicasts the chunks marked for repair once the aggregation delay has elapsed.
+    void MyCom::runningSendRepairs(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Waits for the NACKs of other rovers to be aggregated, and for a correction slot.
+        if (this->repairData_.pendingMask == 0U ||
+            currentMillis - this->repairData_.pendingSinceMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_AGGREGATE ||
+            !MySchedule::getInstance().isCorrectionSlot())
+            return;
+
+        const uint32_t startMicros = micros();
+
+        for (uint8_t slot = 0U; slot < LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE; ++slot)
+        {
+            if ((this->repairData_.pendingMask & static_cast<uint16_t>(1U << slot)) == 0U)
+                continue;
+
+            RepairCacheEntry &entry = this->repairData_.entries[slot];
+
+            // Takes the chunk back out of the epoch in the frame pool, or writes the markers
+            //  again if the static frames did not change since they were sent.
+            uint8_t chunk[ChunkSize];
+            if (entry.markers != 0U)
+            {
+                if (entry.markersGeneration != this->staticCache_.getGeneration())
+                {
+                    ++this->repairStatistics_.unavailable;
+                    continue;
+                }
+
+                this->staticCache_.writeMarkers(entry.markers, chunk);
+            }
+            else
+                MyGPS::getInstance().getFramePool().read(entry.frame, entry.offset, chunk, entry.chunkSize);
+
+            // Re-multicasts the chunk as it was sent the first time, but flagged as a repair
+            //  so that relays do not suppress it.
+            if (this->sendChunkPacket(entry.sequence, entry.flags | protocol::ChunkFlagRepair, chunk, entry.chunkSize))
+                ++this->repairStatistics_.repaired;
+
+            entry.lastSentMillis = currentMillis;
+        }
+
+        this->finishBroadcast();
+        this->repairData_.pendingMask = 0U;
+
+        MySchedule::getInstance().recordTransmission(startMicros, micros());
+    }
+
+    /// @brief Publishes the throughput if the interval has elapsed.
+    void MyCom::runningPublishThroughput(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+        const uint32_t elapsedMillis = currentMillis - this->runningStateData_.throughputSinceMillis;
+
+        // Don't publish if the interval has not elapsed yet.
+        if (elapsedMillis < LACAR_DROID_BASESTATION_FIRMWARE__COM__THROUGHPUT_INTERVAL)
+            return;
+
+        // Publishes the throughput scaled to one second.
+        MyEvents::Event event;
+        event.topic = MyEvents::Topic::Throughput;
+        event.source = MyEvents::Source::Com;
+        event.data.throughput.bytesPerSecond = static_cast<uint16_t>(
+            (static_cast<uint32_t>(this->runningStateData_.throughputBytes) * 1000UL) / elapsedMillis);
+        event.data.throughput.chunksPerSecond = static_cast<uint16_t>(
+            (static_cast<uint32_t>(this->runningStateData_.throughputChunks) * 1000UL) / elapsedMillis);
+        MyEvents::getInstance().publish(event);
+
+        // Reports the delivery statistics when packets had to be retried or dropped.
+        if (this->deliveryStatistics_.retried != this->runningStateData_.reportedRetried ||
+            this->deliveryStatistics_.dropped != this->runningStateData_.reportedDropped)
+        {
+            Serial.print(F("RF24 delivery first_try="));
+            Serial.print(this->deliveryStatistics_.firstTry);
+            Serial.print(F(" retried="));
+            Serial.print(this->deliveryStatistics_.retried);
+            Serial.print(F(" dropped="));
+            Serial.println(this->deliveryStatistics_.dropped);
+
+            this->runningStateData_.reportedRetried = this->deliveryStatistics_.retried;
+            this->runningStateData_.reportedDropped = this->deliveryStatistics_.dropped;
+        }
+
+        // Starts the next interval.
+        this->runningStateData_.throughputSinceMillis = currentMillis;
+        this->runningStateData_.throughputBytes = 0U;
+        this->runningStateData_.throughputChunks = 0U;
     }
 
     // Error state methods.
@@ -71,11 +599,46 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the error state.
     void MyCom::errorEntry(void) noexcept
     {
+        // Publishes the error.
+        MyEvents::getInstance().publishError(MyEvents::Source::Com,
+                                             static_cast<uint8_t>(this->errorCause_));
+
+        // Waits before the first recovery attempt.
+        this->errorStateData_.backoff.start(millis());
     }
 
     /// @brief Do of the error state.
     void MyCom::errorDo(void) noexcept
     {
+        const uint32_t currentMillis = millis();
+        Backoff &backoff = this->errorStateData_.backoff;
+
+        // Don't attempt recovery until the backoff has elapsed, or ever again
+        //  once the retry budget has been used up.
+        if (!backoff.isDue(currentMillis))
+            return;
+
+        backoff.next();
+
+        Serial.print(F("RF24 recovery attempt "));
+        Serial.println(backoff.getAttempts());
+
+        // Re-initializes the radio and the network, and waits for the next attempt
+        //  if that fails.
+        if (!this->beginPeripheral())
+        {
+            backoff.start(currentMillis);
+
+            if (backoff.isExhausted())
+                Serial.println(F("RF24 recovery failed, giving up"));
+
+            return;
+        }
+
+        // Counts the recovery and resumes where we were before the error.
+        ++this->recoveryCounts_[static_cast<uint8_t>(this->errorCause_)];
+        this->errorCause_ = ErrorCause::Ok;
+        this->transition(this->enabled_ ? State::Running : State::Idle);
     }
 
     /// @brief Exit of the error state.
@@ -85,12 +648,274 @@ namespace lacar::droid_basestation::firmware
 
     // Other private methods.
 
+    /// @brief Multicasts the given packet, retrying it according to the retry policy.
+    /// @param header the header of the packet.
+    /// @param payload the payload of the packet.
+    /// @param payloadSize the size of the payload.
+    /// @return false if the packet was dropped after all retries.
+    bool MyCom::multicast(RF24NetworkHeader &header, const void *payload, uint16_t payloadSize) noexcept
+    {
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComMulticast);
+
+        uint16_t retryDelay = LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_RETRY_DELAY;
+
+        for (uint8_t attempt = 0U;; ++attempt)
+        {
+            // Writes the packet, and counts how many attempts it took.
+            if (this->network_.multicast(header, payload, payloadSize))
+            {
+                if (attempt == 0U)
+                    ++this->deliveryStatistics_.firstTry;
+                else
+                    ++this->deliveryStatistics_.retried;
+
+                this->runningStateData_.consecutiveDrops = 0U;
+                return true;
+            }
+
+            // Gives up once all the retries have been used.
+            if (attempt >= LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_RETRIES)
+                break;
+
+            // Gives the TX FIFO some time to drain before the next attempt.
+            delayMicroseconds(retryDelay);
+            retryDelay *= 2U;
+        }
+
+        // Drops the packet.
+        ++this->deliveryStatistics_.dropped;
+        ++this->runningStateData_.consecutiveDrops;
+        return false;
+    }
+
+    /// @brief Broadcasts the given raw packet without an ACK, bypassing RF24Network, the
+    ///  radio stays in TX mode until the burst is finished.
+    /// @param packet the packet.
+    /// @param packetSize the size of the packet.
+    /// @return false if the packet could not be queued.
+    bool MyCom::broadcast(const void *packet, uint8_t packetSize) noexcept
+    {
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComMulticast);
+
+        // Switches to the broadcast address at the start of a burst, RF24Network sets its
+        //  own writing pipe for every write so it does not need to be restored.
+        if (!this->broadcasting_)
+        {
+            this->peripheral_.stopListening();
+            this->peripheral_.openWritingPipe(protocol::RawBroadcastAddress);
+            this->broadcasting_ = true;
+        }
+
+        // Queues the packet in the TX FIFO without an ACK, this only blocks while the FIFO is full.
+        if (!this->peripheral_.writeFast(packet, packetSize, true))
+        {
+            ++this->deliveryStatistics_.dropped;
+            ++this->runningStateData_.consecutiveDrops;
+            return false;
+        }
+
+        ++this->deliveryStatistics_.firstTry;
+        this->runningStateData_.consecutiveDrops = 0U;
+        return true;
+    }
+
+    /// @brief Waits for the raw packets to be sent, and returns to listening for RF24Network.
+    void MyCom::finishBroadcast(void) noexcept
+    {
+        if (!this->broadcasting_)
+            return;
+
+        // Restores the reading pipe 0 address of RF24Network as well.
+        this->peripheral_.txStandBy(LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_TX_TIMEOUT);
+        this->peripheral_.startListening();
+
+        this->broadcasting_ = false;
+    }
+
+    /// @brief Sends the given announcement raw to the rovers if the raw broadcast is used,
+    ///  and through the network to the other base stations.
+    /// @param type the packet type.
+    /// @param announcement the announcement.
+    /// @param announcementSize the size of the announcement.
+    void MyCom::announce(PacketType type, const void *announcement, uint8_t announcementSize) noexcept
+    {
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST
+        // Broadcasts the announcement raw to the rovers.
+        uint8_t packet[protocol::RawPacketSize];
+        RawHeader &rawHeader = *reinterpret_cast<RawHeader *>(packet);
+
+        rawHeader.control = protocol::makeRawControl(type, LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID, 0U);
+        rawHeader.sequence = 0U;
+        memcpy(packet + sizeof(RawHeader), announcement, announcementSize);
+
+        this->broadcast(packet, static_cast<uint8_t>(sizeof(RawHeader) + announcementSize));
+        this->finishBroadcast();
+#endif
+
+        // Multicasts the announcement through the network, the other base stations only listen there.
+        RF24NetworkHeader header(NETWORK_MULTICAST_ADDRESS, static_cast<uint8_t>(type));
+        this->multicast(header, announcement, announcementSize);
+    }
+
+    /// @brief Counts how often the received power detector sees a carrier on the given
+    ///  channel, and returns to the channel in use.
+    /// @param channel the channel to sample.
+    /// @param samples the number of samples.
+    /// @return the number of samples that saw a carrier.
+    uint8_t MyCom::sampleChannel(uint8_t channel, uint8_t samples) noexcept
+    {
+        uint8_t busySamples = 0U;
+
+        this->finishBroadcast();
+
+        this->peripheral_.stopListening();
+        this->peripheral_.setChannel(channel);
+
+        // The detector latches a carrier above -64 dBm while in RX, and is cleared when
+        //  leaving RX, so every sample is a short stay in RX.
+        for (uint8_t i = 0U; i < samples; ++i)
+        {
+            this->peripheral_.startListening();
+            delayMicroseconds(LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_DWELL);
+            if (this->peripheral_.testRPD())
+                ++busySamples;
+            this->peripheral_.stopListening();
+        }
+
+        // Returns to listening for RF24Network on our channel.
+        this->peripheral_.setChannel(this->channelData_.channel);
+        this->peripheral_.startListening();
+
+        return busySamples;
+    }
+
+    /// @brief Samples every candidate channel, and announces the switch to the best one.
+    void MyCom::surveyChannels(void) noexcept
+    {
+        ChannelData &channelData = this->channelData_;
+
+        this->channelSurvey_.reset();
+
+        for (uint8_t i = 0U; i < ChannelSurvey::CandidateCount; ++i)
+        {
+            const uint8_t busySamples = this->sampleChannel(this->channelSurvey_.getChannel(),
+                                                            LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SETUP_SAMPLES);
+            this->channelSurvey_.record(busySamples, LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SETUP_SAMPLES);
+        }
+
+        // The rovers still listen on the configured channel, so the switch is announced there first.
+        const uint8_t channel = this->channelSurvey_.pick(channelData.channel,
+                                                          LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SWITCH_MARGIN);
+        if (channel != channelData.channel)
+        {
+            channelData.nextChannel = channel;
+            channelData.countdown = LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_ANNOUNCE_COUNT;
+        }
+
+        Serial.print(F("RF24 channel survey picked "));
+        Serial.println(channel);
+
+        this->channelSurvey_.reset();
+        channelData.surveySinceMillis = millis();
+    }
+
+    /// @brief Moves the radio to the given channel.
+    /// @param channel the channel.
+    void MyCom::switchChannel(uint8_t channel) noexcept
+    {
+        this->finishBroadcast();
+
+        this->peripheral_.setChannel(channel);
+        this->channelData_.channel = channel;
+        this->channelData_.nextChannel = channel;
+        ++this->channelData_.switches;
+
+        // The samples of the old channel say nothing about the new one.
+        this->channelSurvey_.reset();
+        this->channelData_.surveySinceMillis = millis();
+
+        Serial.print(F("RF24 switched to channel "));
+        Serial.println(channel);
+    }
+
+    /// @brief Builds the chunk packet and sends it, raw or through RF24Network.
+    /// @param sequence the sequence number of the chunk.
+    /// @param flags the chunk flags.
+    /// @param chunk the chunk.
+    /// @param chunkSize the size of the chunk.
+    /// @return false if the packet was dropped.
+    bool MyCom::sendChunkPacket(uint16_t sequence, uint8_t flags, const uint8_t *chunk, uint8_t chunkSize) noexcept
+    {
+        uint8_t packet[MaxChunkPacketSize];
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST
+        uint8_t packetSize = protocol::writeRawChunkPacket(packet, LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID,
+                                                           sequence, flags, chunk, chunkSize);
+#else
+        uint8_t packetSize = protocol::writeChunkPacket(packet, LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID,
+                                                        sequence, flags, chunk, chunkSize);
+#endif
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        // Appends the tag of the epoch to its last chunk, taken from the repair cache so
+        //  that repairs carry it too.
+        if ((flags & protocol::ChunkFlagEpochEnd) != 0U)
+        {
+            const RepairCacheEntry &entry = this->repairData_.entries[sequence % LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE];
+
+            memcpy(packet + packetSize, entry.tag, TagSize);
+            packetSize += TagSize;
+        }
+#endif
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST
+        return this->broadcast(packet, packetSize);
+#else
+        RF24NetworkHeader header(NETWORK_MULTICAST_ADDRESS, static_cast<uint8_t>(PacketType::RTCMStreamChunk));
+        return this->multicast(header, packet, packetSize);
+#endif
+    }
+
+    /// @brief Begins the peripheral and the network.
+    /// @return false if the peripheral could not be started.
+    bool MyCom::beginPeripheral(void) noexcept
+    {
+        // Begins the peripheral.
+        if (!peripheral_.begin())
+            return false;
+
+        // Disables the blind relaying of the network, chunks are relayed by us
+        //  after duplicate suppression.
+        this->network_.multicastRelay = false;
+
+        // Begins the network, on the channel we may have switched to.
+        this->network_.begin(this->channelData_.channel,
+                             LACAR_DROID_BASESTATION_FIRMWARE__RF24__ADDR);
+        
+        // Sets the network level.
+        this->network_.multicastLevel(LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_LEVEL);
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST
+        // Allows the raw broadcast to be written without an ACK.
+        this->peripheral_.enableDynamicAck();
+#endif
+
+        return true;
+    }
+
     /// @brief Transitions to the given state.
     /// @param state the state to transition to.
     void MyCom::transition(State state) noexcept
     {
         currentStateExit();
         this->state_ = state;
+
+        // Publishes the state change before the entry, so that transitions made
+        //  by the entry are published in order.
+        MyEvents::getInstance().publishStateChanged(MyEvents::Source::Com,
+                                                    static_cast<uint8_t>(this->state_),
+                                                    static_cast<uint8_t>(this->errorCause_));
+
         currentStateEntry();
     }
 
@@ -154,6 +979,10 @@ namespace lacar::droid_basestation::firmware
     /// @brief Enables the COM.
     void MyCom::enable(void) noexcept
     {
+        // Remembers that we should be running, so that a recovery from an error
+        //  resumes the running state.
+        this->enabled_ = true;
+
         // Do not enable if not in idle mode.
         if (this->state_ != State::Idle)
             return;
@@ -165,25 +994,33 @@ namespace lacar::droid_basestation::firmware
     /// @brief Performs the setup of the com.
     void MyCom::setup(void) noexcept
     {
-        // Begins the peripheral and makes the initial state the error
-        //  state if it fails.
-        if (!peripheral_.begin())
+        // Registers the radio as the first sink of the corrections.
+        MyGPS::getInstance().addSink("radio", MyCom::staticWriteEpoch, MyCom::staticEpochCapacity, this);
+
+        MyConsole::getInstance().registerCommand(F("chan"), F("prints the radio channel and the occupancy of the candidates"),
+                                                 MyCom::staticHandleCommand, this);
+        MyConsole::getInstance().registerCommand(F("auth"), F("prints the cost of the epoch tags"),
+                                                 MyCom::staticHandleAuthCommand, this);
+        MyConsole::getInstance().registerCommand(F("static"), F("prints the static frames sent in full and as a marker"),
+                                                 MyCom::staticHandleStaticCommand, this);
+
+        // Begins the peripheral and the network, and makes the initial state
+        //  the error state if it fails.
+        if (!this->beginPeripheral())
         {
             this->errorCause_ = ErrorCause::PeripheralBeginFailed;
             this->state_ = State::Error;
+            MyEvents::getInstance().publishStateChanged(MyEvents::Source::Com,
+                                                        static_cast<uint8_t>(this->state_),
+                                                        static_cast<uint8_t>(this->errorCause_));
             this->currentStateEntry();
             return;
         }
 
-        // Enables relaying.
-        this->network_.multicastRelay = true;
-
-        // Begins the network.
-        this->network_.begin(LACAR_DROID_BASESTATION_FIRMWARE__RF24__CHANNEL,
-                       LACAR_DROID_BASESTATION_FIRMWARE__RF24__ADDR);
-        
-        // Sets the network level.
-        this->network_.multicastLevel(0U);
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SURVEY_ENABLED
+        // Looks for the cleanest channel before we start sending.
+        this->surveyChannels();
+#endif
 
         // Sets the current state to idle and enters it.
         this->state_ = State::Idle;
@@ -193,6 +1030,8 @@ namespace lacar::droid_basestation::firmware
     /// @brief Performs the loop of the com.
     void MyCom::loop(void) noexcept
     {
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComLoop);
+
         // Calls the do of the current state.
         currentStateDo();
     }
@@ -200,7 +1039,14 @@ namespace lacar::droid_basestation::firmware
     /// @brief Writes the given RTCM chunk to the stream.
     /// @param chunk the chunk.
     /// @param chunkSize the size of the chunk.
-    void MyCom::writeRTCMStreamChunk(uint8_t *chunk, uint16_t chunkSize) noexcept
+    /// @param flags the chunk flags.
+    /// @param frame the frame in the pool that holds the chunk, which is kept for repairs,
+    ///  or NoBlock if the chunk cannot be repaired.
+    /// @param offset the offset of the chunk in the frame.
+    /// @param markers the mask of the static messages the chunk holds the markers of,
+    ///  which are written again from the static cache for repairs.
+    void MyCom::writeRTCMStreamChunk(const uint8_t *chunk, uint16_t chunkSize, uint8_t flags,
+                                     RTCMFramePool::Handle frame, uint16_t offset, uint8_t markers) noexcept
     {
         // Don't write if we're not in the enabled state.
         if (this->state_ != State::Running)
@@ -209,15 +1055,129 @@ namespace lacar::droid_basestation::firmware
             return;
         }
 
-        // Builds the header.
-        RF24NetworkHeader header(NETWORK_MULTICAST_ADDRESS, static_cast<uint8_t>(PacketType::RTCMStreamChunk));
+        // Don't write chunks that do not fit in a packet.
+        if (chunkSize > ChunkSize)
+        {
+            Serial.println(F("Not writing RTCM stream chunk, too large"));
+            return;
+        }
+
+        // Keeps a reference to the chunk in the repair cache slot of its sequence number, so
+        //  that it can be repaired without a copy, and lets go of the previous one.
+        const uint16_t sequence = this->nextSequence_++;
+        RepairCacheEntry &entry = this->repairData_.entries[sequence % LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE];
+        RTCMFramePool &pool = MyGPS::getInstance().getFramePool();
+
+        if (frame != RTCMFramePool::NoBlock)
+            pool.retain(frame);
+        if (entry.frame != RTCMFramePool::NoBlock)
+            pool.release(entry.frame);
+
+        entry.frame = frame;
+        entry.offset = offset;
+        entry.sequence = sequence;
+        entry.chunkSize = static_cast<uint8_t>(chunkSize);
+        entry.flags = flags;
+        entry.markers = markers;
+        entry.markersGeneration = this->staticCache_.getGeneration();
+        entry.lastSentMillis = millis();
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        if ((flags & protocol::ChunkFlagEpochEnd) != 0U)
+            memcpy(entry.tag, this->epochTag_, TagSize);
+#endif
+
+        // Clears a repair that is still pending for the previous chunk in this slot.
+        this->repairData_.pendingMask &= static_cast<uint16_t>(~(1U << (sequence % LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE)));
+
+        // Marks our own chunk as seen, in case it's relayed back to us.
+        this->getRelaySourceWindow(LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID).accept(sequence);
+
+        // Writes the message to the droids, a dropped chunk is only an error
+        //  once too many chunks in a row have been dropped. The drops are counted in
+        //  the delivery statistics and reported with the throughput, not here in the burst.
+        if (!this->sendChunkPacket(sequence, flags, chunk, static_cast<uint8_t>(chunkSize)))
+        {
+            if (this->runningStateData_.consecutiveDrops >= LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_MAX_CONSECUTIVE_DROPS)
+            {
+                Serial.println(F("RF24 network RTCM chunk multicast failed"));
+                this->errorCause_ = ErrorCause::PeripheralMulticastFailed;
+                this->transition(State::Error);
+            }
+
+            return;
+        }
+
+        // Counts the chunk towards the throughput.
+        this->runningStateData_.throughputBytes += chunkSize;
+        ++this->runningStateData_.throughputChunks;
+    }
+
+    /// @brief Writes a chunk of the epoch being sent, and adds it to its tag.
+    /// @param chunk the chunk.
+    /// @param frame the frame in the pool that holds the epoch, or NoBlock.
+    void MyCom::writeRTCMEpochChunk(const protocol::RTCMEpochChunker::Chunk &chunk, RTCMFramePool::Handle frame) noexcept
+    {
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        const bool last = (chunk.flags & protocol::ChunkFlagEpochEnd) != 0U;
+
+        // The last chunk carries the tag, so the tag is finished before it is sent.
+        if (last)
+        {
+            LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComAuthenticate);
+            this->epochMac_.update(chunk.data, chunk.size);
+            this->epochMac_.finish(this->epochTag_, TagSize);
+        }
+#endif
+
+        // The markers are not in the frame, they are written again from the static cache for repairs.
+        this->writeRTCMStreamChunk(chunk.data, chunk.size, chunk.flags,
+                                   chunk.markers == 0U ? frame : RTCMFramePool::NoBlock, chunk.offset, chunk.markers);
 
-        // Writes the message to the droids.
-        if (!network_.multicast(header, chunk, chunkSize))
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        // Every other chunk is added to the tag after it is sent, while the radio drains the
+        //  TX FIFO, so no chunk waits for its own pass of the MAC.
+        if (!last)
         {
-            Serial.println(F("RF24 network RTCM chunk multicast failed"));
-            this->errorCause_ = ErrorCause::PeripheralMulticastFailed;
-            this->transition(State::Error);
+            LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(ComAuthenticate);
+            this->epochMac_.update(chunk.data, chunk.size);
         }
+
+        this->authStatistics_.bytes += chunk.size;
+#endif
+    }
+
+    /// @brief Writes the given RTCM epoch to the stream as one burst of chunks, the
+    ///  last of which carries the epoch end flag (and the tag of the epoch).
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param frame the frame in the pool that holds the epoch, or NoBlock.
+    void MyCom::writeRTCMEpoch(const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept
+    {
+        const uint32_t startMicros = micros();
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        // The tag covers the sequence number of the first chunk.
+        protocol::beginEpochTag(this->epochMac_, this->authKey_, LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID, this->nextSequence_);
+        ++this->authStatistics_.epochs;
+#endif
+
+        // Replaces the runs of unchanged static frames by their markers, the tag covers the
+        //  markers as sent.
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__STATIC_DEDUP_ENABLED
+        protocol::RTCMStaticCache *const staticCache = &this->staticCache_;
+#else
+        protocol::RTCMStaticCache *const staticCache = nullptr;
+#endif
+        protocol::RTCMEpochChunker chunker(epoch, epochSize, ChunkSize, TagSize, staticCache, millis());
+        protocol::RTCMEpochChunker::Chunk chunk;
+
+        // Writes the chunks back-to-back, stopping if the com fails in between.
+        while (this->state_ == State::Running && chunker.next(chunk))
+            this->writeRTCMEpochChunk(chunk, frame);
+
+        this->finishBroadcast();
+
+        // Records the burst for the slot occupancy.
+        MySchedule::getInstance().recordTransmission(startMicros, micros());
     }
-}
\ No newline at end of file
+}
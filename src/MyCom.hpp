@@ -2,6 +2,15 @@
 
 #include <RF24.h>
 #include <RF24Network.h>
+#include "Backoff.hpp"
+#include "SequenceWindow.hpp"
+#include <DroidProtocol.hpp>
+#include <ChaskeyMac.hpp>
+#include "RTCMFramePool.hpp"
+#include "ChannelSurvey.hpp"
+#include <RTCMStaticCache.hpp>
+#include <RTCMEpochChunker.hpp>
+#include "config.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
@@ -15,6 +24,9 @@ namespace lacar::droid_basestation::firmware
             PeripheralMulticastFailed = 2,
         };
 
+        /// @brief The number of error causes, including Ok.
+        static constexpr uint8_t ErrorCauseCount = 3U;
+
         enum class State : uint8_t
         {
             Idle = 0,
@@ -22,9 +34,154 @@ namespace lacar::droid_basestation::firmware
             Error = 2,
         };
 
-        enum class PacketType : uint8_t
+        typedef protocol::PacketType PacketType;
+        typedef protocol::RTCMStreamChunkHeader RTCMStreamChunkHeader;
+        typedef protocol::NackHeader NackHeader;
+        typedef protocol::NackRange NackRange;
+        typedef protocol::ScheduleAnnouncement ScheduleAnnouncement;
+        typedef protocol::ChannelAnnouncement ChannelAnnouncement;
+        typedef protocol::RawHeader RawHeader;
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST
+        /// @brief The size of the data in a chunk, filling a raw broadcast packet.
+        static constexpr uint8_t ChunkSize = protocol::RawPayloadSize;
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID <= protocol::RawMaxStation,
+                      "The station ID must fit in the control byte of a raw broadcast packet");
+        static_assert(!LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_ENABLED,
+                      "Raw broadcast chunks are not received by the relays");
+#else
+        /// @brief The size of the data in a chunk.
+        static constexpr uint8_t ChunkSize = LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_SIZE;
+#endif
+
+        /// @brief The size of the largest chunk packet, raw or through RF24Network.
+        static constexpr uint8_t MaxChunkPacketSize = sizeof(RTCMStreamChunkHeader) + ChunkSize;
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        /// @brief The size of the tag at the end of the last chunk of an epoch.
+        static constexpr uint8_t TagSize = protocol::EpochTagSize;
+#else
+        static constexpr uint8_t TagSize = 0U;
+#endif
+
+        /// @brief A recently sent chunk, kept to repair it when a rover reports it missing. The
+        ///  data is not copied, the entry holds a reference to the epoch in the frame pool.
+        struct RepairCacheEntry
+        {
+        public:
+            uint32_t lastSentMillis;
+            uint16_t sequence;
+            uint16_t offset;
+            RTCMFramePool::Handle frame;
+            uint8_t chunkSize;
+            uint8_t flags;
+            uint8_t markers;
+            uint8_t markersGeneration;
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+            uint8_t tag[protocol::EpochTagSize];
+#endif
+        };
+
+        static_assert(protocol::StaticMessageCount * sizeof(protocol::StaticMarker) + TagSize <= ChunkSize,
+                      "The markers of every static message and the tag must fit in a single chunk");
+
+        /// @brief The recently sent chunks and the repairs waiting to be sent.
+        struct RepairData
+        {
+        public:
+            RepairCacheEntry entries[LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE];
+            uint32_t pendingSinceMillis;
+            uint16_t pendingMask;
+        };
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE <= 16,
+                      "The pending repairs of the cache must fit in the 16-bit pending mask");
+        static_assert((LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE &
+                       (LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE - 1)) == 0,
+                      "The repair cache size must be a power of two, so that the slots stay in step across the sequence wrap");
+
+        /// @brief The seen sequence numbers of a single source station.
+        struct RelaySource
+        {
+        public:
+            uint32_t lastSeenMillis;
+            uint8_t station;
+            bool used;
+            SequenceWindow window;
+        };
+
+        /// @brief The statistics of the received and relayed chunks.
+        struct RelayStatistics
+        {
+        public:
+            uint32_t received;
+            uint32_t duplicates;
+            uint32_t relayed;
+        };
+
+        /// @brief The statistics of the selective repair.
+        struct RepairStatistics
         {
-            RTCMStreamChunk = 0,
+        public:
+            uint32_t nacksReceived;
+            uint32_t repaired;
+            uint32_t suppressed;
+            uint32_t unavailable;
+        };
+
+        /// @brief The data of the running state.
+        struct RunningStateData
+        {
+        public:
+            uint32_t throughputSinceMillis;
+            uint16_t throughputBytes;
+            uint16_t throughputChunks;
+            uint32_t reportedRetried;
+            uint32_t reportedDropped;
+            uint32_t lastAnnouncedFrame;
+            uint8_t consecutiveDrops;
+        };
+
+        /// @brief The delivery statistics of the multicast packets.
+        struct DeliveryStatistics
+        {
+        public:
+            uint32_t firstTry;
+            uint32_t retried;
+            uint32_t dropped;
+        };
+
+        /// @brief The tagged epochs, the cycles they took are in the com_authenticate zone.
+        struct AuthStatistics
+        {
+        public:
+            uint32_t epochs;
+            uint32_t bytes;
+        };
+
+        /// @brief The channel in use, the background survey and the announced switch.
+        struct ChannelData
+        {
+        public:
+            uint32_t lastSampleMillis;
+            uint32_t surveySinceMillis;
+            uint32_t lastAnnouncedMillis;
+            uint32_t switches;
+            uint8_t channel;
+            uint8_t nextChannel;
+            uint8_t countdown;
+        };
+
+        /// @brief The data of the error state.
+        struct ErrorStateData
+        {
+        public:
+            Backoff backoff;
+
+        public:
+            /// @brief Constructs an empty error state data instance.
+            ErrorStateData(void) noexcept;
         };
 
     private:
@@ -36,11 +193,41 @@ namespace lacar::droid_basestation::firmware
             return s_Instance;
         }
 
+    private:
+        /// @brief The command that prints the channel and the occupancy of the candidates.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+        /// @brief The command that prints the cost of the epoch tags.
+        static void staticHandleAuthCommand(void *u, const char *arguments) noexcept;
+
+        /// @brief The command that prints the static frames sent in full and as a marker.
+        static void staticHandleStaticCommand(void *u, const char *arguments) noexcept;
+
     private:
         RF24 peripheral_;
         RF24Network network_;
+        RunningStateData runningStateData_;
+        ErrorStateData errorStateData_;
+        DeliveryStatistics deliveryStatistics_;
+        RepairData repairData_;
+        RepairStatistics repairStatistics_;
+        RelaySource relaySources_[LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_MAX_SOURCES];
+        RelayStatistics relayStatistics_;
+        ChannelSurvey channelSurvey_;
+        ChannelData channelData_;
+#if LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED
+        protocol::ChaskeyMac::Key authKey_;
+        uint8_t epochTag_[protocol::EpochTagSize];
+        protocol::ChaskeyMac epochMac_;
+        AuthStatistics authStatistics_;
+#endif
+        protocol::RTCMStaticCache staticCache_;
+        uint16_t nextSequence_;
+        uint16_t recoveryCounts_[ErrorCauseCount];
         ErrorCause errorCause_;
         State state_;
+        bool enabled_;
+        bool broadcasting_;
 
     public:
         /// @brief Constructs a new com instance.
@@ -59,6 +246,42 @@ namespace lacar::droid_basestation::firmware
             return this->errorCause_;
         }
 
+        /// @brief Gets the delivery statistics of the multicast packets.
+        /// @return the delivery statistics.
+        inline const DeliveryStatistics &getDeliveryStatistics(void) const noexcept
+        {
+            return this->deliveryStatistics_;
+        }
+
+        /// @brief Gets the statistics of the selective repair.
+        /// @return the repair statistics.
+        inline const RepairStatistics &getRepairStatistics(void) const noexcept
+        {
+            return this->repairStatistics_;
+        }
+
+        /// @brief Gets the channel in use.
+        /// @return the channel.
+        inline uint8_t getChannel(void) const noexcept
+        {
+            return this->channelData_.channel;
+        }
+
+        /// @brief Gets the statistics of the received and relayed chunks.
+        /// @return the relay statistics.
+        inline const RelayStatistics &getRelayStatistics(void) const noexcept
+        {
+            return this->relayStatistics_;
+        }
+
+        /// @brief Gets the number of recoveries from the given error cause.
+        /// @param errorCause the error cause.
+        /// @return the number of recoveries.
+        inline uint16_t getRecoveryCount(ErrorCause errorCause) const noexcept
+        {
+            return this->recoveryCounts_[static_cast<uint8_t>(errorCause)];
+        }
+
     private:
         // Idle state methods.
 
@@ -82,6 +305,46 @@ namespace lacar::droid_basestation::firmware
         /// @brief Exit of the running state.
         void runningExit(void) noexcept;
 
+        /// @brief Publishes the throughput if the interval has elapsed.
+        void runningPublishThroughput(void) noexcept;
+
+        /// @brief Announces the TDMA schedule at the start of the first correction slot of a frame.
+        void runningAnnounceSchedule(void) noexcept;
+
+        /// @brief Samples the next candidate channel in a short burst while we're not expected
+        ///  to send or listen, and picks the channel once every candidate has been sampled.
+        void runningSurveyChannels(void) noexcept;
+
+        /// @brief Announces the pending switch to another channel, and switches after the
+        ///  last announcement.
+        void runningAnnounceChannel(void) noexcept;
+
+        /// @brief Follows the channel switch announced by another base station.
+        /// @param packet the announcement.
+        /// @param packetSize the size of the announcement.
+        void runningHandleChannel(const uint8_t *packet, uint16_t packetSize) noexcept;
+
+        /// @brief Marks the chunks in the NACK of a rover for repair.
+        /// @param nack the NACK.
+        /// @param nackSize the size of the NACK.
+        void runningHandleNack(const uint8_t *nack, uint16_t nackSize) noexcept;
+
+        /// @brief Suppresses duplicates of a chunk from another station or relay, and relays it to
+        ///  the next level if there are nodes that need it.
+        /// @param header the network header of the chunk.
+        /// @param packet the chunk.
+        /// @param packetSize the size of the chunk.
+        void runningHandleChunk(RF24NetworkHeader &header, const uint8_t *packet, uint16_t packetSize) noexcept;
+
+        /// @brief Gets the sequence window of the given source station, replacing the least
+        ///  recently seen source if it is not known yet.
+        /// @param station the source station.
+        /// @return the sequence window.
+        SequenceWindow &getRelaySourceWindow(uint8_t station) noexcept;
+
+        /// @brief Re-multicasts the chunks marked for repair once the aggregation delay has elapsed.
+        void runningSendRepairs(void) noexcept;
+
         // Error state methods.
 
         /// @brief Entry of the error state.
@@ -95,6 +358,69 @@ namespace lacar::droid_basestation::firmware
 
         // Other private methods.
 
+        /// @brief Multicasts the given packet, retrying it according to the retry policy.
+        /// @param header the header of the packet.
+        /// @param payload the payload of the packet.
+        /// @param payloadSize the size of the payload.
+        /// @return false if the packet was dropped after all retries.
+        bool multicast(RF24NetworkHeader &header, const void *payload, uint16_t payloadSize) noexcept;
+
+        /// @brief Broadcasts the given raw packet without an ACK, bypassing RF24Network, the
+        ///  radio stays in TX mode until the burst is finished.
+        /// @param packet the packet.
+        /// @param packetSize the size of the packet.
+        /// @return false if the packet could not be queued.
+        bool broadcast(const void *packet, uint8_t packetSize) noexcept;
+
+        /// @brief Waits for the raw packets to be sent, and returns to listening for RF24Network.
+        void finishBroadcast(void) noexcept;
+
+        /// @brief Sends the given announcement raw to the rovers if the raw broadcast is used,
+        ///  and through the network to the other base stations.
+        /// @param type the packet type.
+        /// @param announcement the announcement.
+        /// @param announcementSize the size of the announcement.
+        void announce(PacketType type, const void *announcement, uint8_t announcementSize) noexcept;
+
+        /// @brief Counts how often the received power detector sees a carrier on the given
+        ///  channel, and returns to the channel in use.
+        /// @param channel the channel to sample.
+        /// @param samples the number of samples.
+        /// @return the number of samples that saw a carrier.
+        uint8_t sampleChannel(uint8_t channel, uint8_t samples) noexcept;
+
+        /// @brief Samples every candidate channel, and announces the switch to the best one.
+        void surveyChannels(void) noexcept;
+
+        /// @brief Moves the radio to the given channel.
+        /// @param channel the channel.
+        void switchChannel(uint8_t channel) noexcept;
+
+        /// @brief Builds the chunk packet and sends it, raw or through RF24Network.
+        /// @param sequence the sequence number of the chunk.
+        /// @param flags the chunk flags.
+        /// @param chunk the chunk.
+        /// @param chunkSize the size of the chunk.
+        /// @return false if the packet was dropped.
+        bool sendChunkPacket(uint16_t sequence, uint8_t flags, const uint8_t *chunk, uint8_t chunkSize) noexcept;
+
+        /// @brief The sink that writes the flushed epochs to the radio.
+        /// @param u the user data (MyCom class instance).
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param frame the frame holding the epoch in the pool, kept for repairs.
+        /// @return false if the com is not running.
+        static bool staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept;
+
+        /// @brief The capacity of the radio sink, nothing while the com is not running.
+        /// @param u the user data (MyCom class instance).
+        /// @return the number of bytes the sink accepts.
+        static uint16_t staticEpochCapacity(void *u) noexcept;
+
+        /// @brief Begins the peripheral and the network.
+        /// @return false if the peripheral could not be started.
+        bool beginPeripheral(void) noexcept;
+
         /// @brief Transitions to the given state.
         /// @param state the state to transition to.
         void transition(State state) noexcept;
@@ -121,6 +447,27 @@ namespace lacar::droid_basestation::firmware
         /// @brief Writes the given RTCM chunk to the stream.
         /// @param chunk the chunk.
         /// @param chunkSize the size of the chunk.
-        void writeRTCMStreamChunk(uint8_t *chunk, uint16_t chunkSize) noexcept;
+        /// @param flags the chunk flags.
+        /// @param frame the frame in the pool that holds the chunk, which is kept for repairs,
+        ///  or NoBlock if the chunk cannot be repaired.
+        /// @param offset the offset of the chunk in the frame.
+        /// @param markers the mask of the static messages the chunk holds the markers of,
+        ///  which are written again from the static cache for repairs.
+        void writeRTCMStreamChunk(const uint8_t *chunk, uint16_t chunkSize, uint8_t flags = 0U,
+                                  RTCMFramePool::Handle frame = RTCMFramePool::NoBlock, uint16_t offset = 0U,
+                                  uint8_t markers = 0U) noexcept;
+
+        /// @brief Writes a chunk of the epoch being sent, and adds it to its tag.
+        /// @param chunk the chunk.
+        /// @param frame the frame in the pool that holds the epoch, or NoBlock.
+        void writeRTCMEpochChunk(const protocol::RTCMEpochChunker::Chunk &chunk, RTCMFramePool::Handle frame) noexcept;
+
+        /// @brief Writes the given RTCM epoch to the stream as one burst of chunks, the
+        ///  last of which carries the epoch end flag.
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param frame the frame in the pool that holds the epoch, or NoBlock.
+        void writeRTCMEpoch(const uint8_t *epoch, uint16_t epochSize,
+                            RTCMFramePool::Handle frame = RTCMFramePool::NoBlock) noexcept;
     };
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "MyConsole.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    MyConsole MyConsole::s_Instance;
+
+    /// @brief Constructs a new console instance.
+    MyConsole::MyConsole(void) noexcept
+        : commands_(),
+          line_(),
+          lineSize_(0U),
+          commandCount_(0U),
+          overflowed_(false)
+    {
+    }
+
+    /// @brief Executes the command on the current line.
+    void MyConsole::execute(void) noexcept
+    {
+        // Splits the name of the command from its arguments.
+        char *arguments = this->line_;
+        while (*arguments != '\0' && *arguments != ' ')
+            ++arguments;
+
+        if (*arguments == ' ')
+        {
+            *arguments++ = '\0';
+
+            while (*arguments == ' ')
+                ++arguments;
+        }
+
+        if (strcmp_P(this->line_, PSTR("help")) == 0)
+        {
+            this->printHelp();
+            return;
+        }
+
+        // Calls the command with the given name.
+        for (uint8_t i = 0U; i < this->commandCount_; ++i)
+        {
+            const Command &command = this->commands_[i];
+
+            if (strcmp_P(this->line_, reinterpret_cast<const char *>(command.name)) == 0)
+            {
+                command.callback(command.userData, arguments);
+                return;
+            }
+        }
+
+        Serial.print(F("Unknown command: "));
+        Serial.println(this->line_);
+    }
+
+    /// @brief Prints the registered commands.
+    void MyConsole::printHelp(void) noexcept
+    {
+        for (uint8_t i = 0U; i < this->commandCount_; ++i)
+        {
+            Serial.print(this->commands_[i].name);
+            Serial.print(F(" - "));
+            Serial.println(this->commands_[i].help);
+        }
+    }
+
+    /// @brief Registers the given command.
+    /// @param name the name of the command, stored in flash.
+    /// @param help the description of the command, stored in flash.
+    /// @param callback the callback to call.
+    /// @param userData the user data passed to the callback.
+    /// @return false if there is no room for another command.
+    bool MyConsole::registerCommand(const __FlashStringHelper *name, const __FlashStringHelper *help,
+                                    CommandCallback callback, void *userData) noexcept
+    {
+        // Makes sure there is room for the command.
+        if (this->commandCount_ >= LACAR_DROID_BASESTATION_FIRMWARE__CONSOLE__MAX_COMMANDS)
+            return false;
+
+        // Stores the command.
+        Command &command = this->commands_[this->commandCount_++];
+        command.name = name;
+        command.help = help;
+        command.callback = callback;
+        command.userData = userData;
+
+        return true;
+    }
+
+    /// @brief Performs the setup of the console.
+    void MyConsole::setup(void) noexcept
+    {
+        this->lineSize_ = 0U;
+        this->overflowed_ = false;
+    }
+
+    /// @brief Reads the available characters, and executes the command once a line is complete.
+    void MyConsole::loop(void) noexcept
+    {
+        while (Serial.available() > 0)
+        {
+            const char c = static_cast<char>(Serial.read());
+
+            if (c == '\r' || c == '\n')
+            {
+                // Discards lines that did not fit in the buffer.
+                if (this->overflowed_)
+                    Serial.println(F("Command too long"));
+                else if (this->lineSize_ > 0U)
+                {
+                    this->line_[this->lineSize_] = '\0';
+                    this->execute();
+                }
+
+                this->lineSize_ = 0U;
+                this->overflowed_ = false;
+                continue;
+            }
+
+            // Keeps room for the terminator.
+            if (this->lineSize_ >= sizeof(this->line_) - 1U)
+            {
+                this->overflowed_ = true;
+                continue;
+            }
+
+            this->line_[this->lineSize_++] = c;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief A line based command console on the serial port, the modules register their
+    ///  diagnostic commands during their setup.
+    class MyConsole
+    {
+    public:
+        /// @brief The callback that gets called when a command is entered, with the rest of the line.
+        typedef void (*CommandCallback)(void *, const char *);
+
+        /// @brief A single registered command.
+        struct Command
+        {
+        public:
+            const __FlashStringHelper *name;
+            const __FlashStringHelper *help;
+            CommandCallback callback;
+            void *userData;
+        };
+
+    private:
+        static MyConsole s_Instance;
+
+    public:
+        /// @brief Gets the current console instance.
+        /// @return The console instance.
+        static inline MyConsole &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+    private:
+        Command commands_[LACAR_DROID_BASESTATION_FIRMWARE__CONSOLE__MAX_COMMANDS];
+        char line_[LACAR_DROID_BASESTATION_FIRMWARE__CONSOLE__LINE_SIZE];
+        uint8_t lineSize_;
+        uint8_t commandCount_;
+        bool overflowed_;
+
+    public:
+        /// @brief Constructs a new console instance.
+        MyConsole(void) noexcept;
+
+    private:
+        /// @brief Executes the command on the current line.
+        void execute(void) noexcept;
+
+        /// @brief Prints the registered commands.
+        void printHelp(void) noexcept;
+
+    public:
+        /// @brief Registers the given command.
+        /// @param name the name of the command, stored in flash.
+        /// @param help the description of the command, stored in flash.
+        /// @param callback the callback to call.
+        /// @param userData the user data passed to the callback.
+        /// @return false if there is no room for another command.
+        bool registerCommand(const __FlashStringHelper *name, const __FlashStringHelper *help,
+                             CommandCallback callback, void *userData) noexcept;
+
+        /// @brief Performs the setup of the console.
+        void setup(void) noexcept;
+
+        /// @brief Reads the available characters, and executes the command once a line is complete.
+        void loop(void) noexcept;
+    };
+}
@@ -1,7 +1,8 @@
 #include "config.hpp"
 #include "MyDisplay.hpp"
-#include "MyCom.hpp"
 #include "MyGPS.hpp"
+#include "MyCom.hpp"
+#include "MyProfiler.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
@@ -12,7 +13,8 @@ namespace lacar::droid_basestation::firmware
         : surveyStateData_(),
           overviewStateData_(),
           lastUpdateMillis_(),
-          rows_(2U), cols_(16U),
+          rows_(Rows), cols_(Cols),
+          shownLines_(),
           peripheral_(0x27, rows_, cols_),
           state_(State::Idle)
     {
@@ -40,23 +42,18 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the survey state.
     void MyDisplay::surveyEntry(void) noexcept
     {
-        this->surveyStateData_.hasPreviousObservation = false;
+        this->surveyStateData_.displayed = false;
     }
 
     /// @brief Do of the survey state.
     void MyDisplay::surveyDo(void) noexcept
     {
-        // Gets the enabling state data.
-        const MyGPS::EnablingStateData &enablingStateData =
-            MyGPS::getInstance().getEnablingStateData();
-
         // Don't do anything if nothing changed.
-        if (this->surveyStateData_.hasPreviousObservation && this->surveyStateData_.previousMeanAccuracy == enablingStateData.meanAccuracy &&
-            this->surveyStateData_.previousObservationTime == enablingStateData.elapsedObservationTime)
+        if (this->surveyStateData_.displayed)
             return;
 
         // Clears the display.
-        this->peripheral_.clear();
+        this->clear();
 
         // Show that we're surveying.
         this->peripheral_.setCursor(0U, 0U);
@@ -65,14 +62,12 @@ namespace lacar::droid_basestation::firmware
         // Show the mean accuracy and the elapsed observation time.
         this->peripheral_.setCursor(0U, 1U);
         this->peripheral_.print(F("E:"));
-        this->peripheral_.print(min(enablingStateData.meanAccuracy, 999.9), 2);
+        this->peripheral_.print(min(this->surveyStateData_.meanAccuracy, 999.9), 2);
         this->peripheral_.print(F(" T:"));
-        this->peripheral_.print(min(enablingStateData.elapsedObservationTime, 99999));
+        this->peripheral_.print(min(this->surveyStateData_.elapsedObservationTime, 99999));
 
-        // Stores the current observation as the previous observation.
-        this->surveyStateData_.hasPreviousObservation = true;
-        this->surveyStateData_.previousMeanAccuracy = enablingStateData.meanAccuracy;
-        this->surveyStateData_.previousObservationTime = enablingStateData.elapsedObservationTime;
+        // Marks the current observation as displayed.
+        this->surveyStateData_.displayed = true;
     }
 
     /// @brief Exit of the survey state.
@@ -86,46 +81,57 @@ namespace lacar::droid_basestation::firmware
     void MyDisplay::overviewEntry(void) noexcept
     {
         // Clears the screen.
-        this->peripheral_.clear();
+        this->clear();
 
-        // Sets displayed to false.
+        // Starts at the status page and sets displayed to false.
+        this->overviewStateData_.page = Page::Status;
+        this->overviewStateData_.pageSinceMillis = millis();
         this->overviewStateData_.displayed = false;
     }
 
     /// @brief Do of the overview state.
     void MyDisplay::overviewDo(void) noexcept
     {
-        char buffer[17] = {0x00};
+        const uint32_t currentMillis = millis();
 
-        // Do not update the display if nothing has changed.
-        if (this->overviewStateData_.displayed == true &&
-            this->overviewStateData_.gpsState == static_cast<uint8_t>(MyGPS::getInstance().getState()) &&
-            this->overviewStateData_.comState == static_cast<uint8_t>(MyCom::getInstance().getState()) &&
-            this->overviewStateData_.gpsErrorCause == static_cast<uint8_t>(MyGPS::getInstance().getErrorCause()) &&
-            this->overviewStateData_.comErrorCause == static_cast<uint8_t>(MyCom::getInstance().getErrorCause()))
-            return;
+        // Moves on to the next page once the current one has been shown long enough.
+        if (currentMillis - this->overviewStateData_.pageSinceMillis >= LACAR_DROID_BASESTATION_FIRMWARE__DISPLAY__PAGE_INTERVAL)
+        {
+            this->overviewStateData_.page = static_cast<Page>(
+                (static_cast<uint8_t>(this->overviewStateData_.page) + 1U) % PageCount);
+            this->overviewStateData_.pageSinceMillis = currentMillis;
+            this->overviewStateData_.displayed = false;
+        }
 
-        // Writes the first line of the LCD.
-        this->peripheral_.setCursor(0U, 0U);
-        this->peripheral_.print("COM|GPS");
+        // Do not update the status page if nothing has changed. The other pages show live
+        //  counters and are formatted on every update while they're visible, but printLine
+        //  only writes the columns that changed.
+        if (this->overviewStateData_.page == Page::Status && this->overviewStateData_.displayed)
+            return;
 
-        // Writes the second line containing the task status codes.
-        sprintf(buffer, "%01d%02d|%01d%02d", 
-                static_cast<uint8_t>(MyCom::getInstance().getState()),
-                static_cast<uint8_t>(MyCom::getInstance().getErrorCause()),
-                static_cast<uint8_t>(MyGPS::getInstance().getState()),
-                static_cast<uint8_t>(MyGPS::getInstance().getErrorCause()));
-        this->peripheral_.setCursor(0U, 1U);
-        this->peripheral_.print(buffer);
+        switch (this->overviewStateData_.page)
+        {
+        case Page::Status:
+            this->overviewRenderStatus();
+            break;
+        case Page::Throughput:
+            this->overviewRenderThroughput();
+            break;
+        case Page::Drops:
+            this->overviewRenderDrops();
+            break;
+        case Page::Satellites:
+            this->overviewRenderSatellites();
+            break;
+        case Page::Time:
+            this->overviewRenderTime();
+            break;
+        default:
+            break;
+        }
 
         // Sets displayed to true.
         this->overviewStateData_.displayed = true;
-
-        // Updates the previous values.
-        this->overviewStateData_.gpsState = static_cast<uint8_t>(MyGPS::getInstance().getState());
-        this->overviewStateData_.comState = static_cast<uint8_t>(MyCom::getInstance().getState());
-        this->overviewStateData_.gpsErrorCause = static_cast<uint8_t>(MyGPS::getInstance().getErrorCause());
-        this->overviewStateData_.comErrorCause = static_cast<uint8_t>(MyCom::getInstance().getErrorCause());
     }
 
     /// @brief Exit of the overview state.
@@ -133,6 +139,162 @@ namespace lacar::droid_basestation::firmware
     {
     }
 
+    /// @brief Renders the page with the task states and error causes.
+    void MyDisplay::overviewRenderStatus(void) noexcept
+    {
+        char buffer[17] = {0x00};
+
+        // Writes the first line of the LCD.
+        this->printLine(0U, "COM|GPS");
+
+        // Writes the second line containing the task status codes.
+        snprintf(buffer, sizeof(buffer), "%01d%02d|%01d%02d",
+                 this->overviewStateData_.comState,
+                 this->overviewStateData_.comErrorCause,
+                 this->overviewStateData_.gpsState,
+                 this->overviewStateData_.gpsErrorCause);
+        this->printLine(1U, buffer);
+    }
+
+    /// @brief Renders the page with the correction throughput.
+    void MyDisplay::overviewRenderThroughput(void) noexcept
+    {
+        char buffer[17] = {0x00};
+
+        // Writes the bytes per second sent over the radio.
+        snprintf(buffer, sizeof(buffer), "Bytes/s %5u",
+                 this->overviewStateData_.bytesPerSecond);
+        this->printLine(0U, buffer);
+
+        // Writes the RTCM frames received and the chunks sent per second.
+        snprintf(buffer, sizeof(buffer), "Fr/s%4u Ch/s%4u",
+                 min(this->overviewStateData_.framesPerSecond, 9999U),
+                 min(this->overviewStateData_.chunksPerSecond, 9999U));
+        this->printLine(1U, buffer);
+    }
+
+    /// @brief Renders the page with the retried and dropped counters.
+    void MyDisplay::overviewRenderDrops(void) noexcept
+    {
+        const MyCom::DeliveryStatistics &deliveryStatistics = MyCom::getInstance().getDeliveryStatistics();
+        const MyGPS &gps = MyGPS::getInstance();
+        char buffer[17] = {0x00};
+
+        // Writes the retried and dropped radio packets.
+        snprintf(buffer, sizeof(buffer), "RF R%5lu D%5lu",
+                 static_cast<unsigned long>(min(deliveryStatistics.retried, 99999UL)),
+                 static_cast<unsigned long>(min(deliveryStatistics.dropped, 99999UL)));
+        this->printLine(0U, buffer);
+
+        // Writes the epochs dropped by the sinks and the frames dropped by the epoch buffer.
+        snprintf(buffer, sizeof(buffer), "Snk%5lu Frm%4u",
+                 static_cast<unsigned long>(min(gps.getDroppedEpochs(), 99999UL)),
+                 min(gps.getDroppedFrames(), 9999U));
+        this->printLine(1U, buffer);
+    }
+
+    /// @brief Renders the page with the satellites per constellation.
+    void MyDisplay::overviewRenderSatellites(void) noexcept
+    {
+        const MyGPS &gps = MyGPS::getInstance();
+        char buffer[17] = {0x00};
+
+        // Writes GPS, GLONASS and Galileo.
+        snprintf(buffer, sizeof(buffer), "G%02u R%02u E%02u",
+                 gps.getSatellites(0U), gps.getSatellites(1U), gps.getSatellites(2U));
+        this->printLine(0U, buffer);
+
+        // Writes BeiDou, QZSS and SBAS.
+        snprintf(buffer, sizeof(buffer), "C%02u J%02u S%02u",
+                 gps.getSatellites(5U), gps.getSatellites(4U), gps.getSatellites(3U));
+        this->printLine(1U, buffer);
+    }
+
+    /// @brief Renders the page with the correction age and the uptime.
+    void MyDisplay::overviewRenderTime(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+        const uint32_t lastFlushMillis = MyGPS::getInstance().getLastFlushMillis();
+        char buffer[17] = {0x00};
+
+        // Writes the age of the last epoch in tenths of a second, if there has been one.
+        if (lastFlushMillis == 0U)
+        {
+            this->printLine(0U, "Age    ---");
+        }
+        else
+        {
+            const uint32_t ageTenths = min((currentMillis - lastFlushMillis) / 100UL, 9999UL);
+
+            snprintf(buffer, sizeof(buffer), "Age %3lu.%01lus",
+                     static_cast<unsigned long>(ageTenths / 10UL),
+                     static_cast<unsigned long>(ageTenths % 10UL));
+            this->printLine(0U, buffer);
+        }
+
+        // Writes the uptime in days, hours, minutes and seconds.
+        const uint32_t uptimeSeconds = currentMillis / 1000UL;
+        snprintf(buffer, sizeof(buffer), "Up %3lud %02u:%02u:%02u",
+                 static_cast<unsigned long>(uptimeSeconds / 86400UL),
+                 static_cast<unsigned int>((uptimeSeconds / 3600UL) % 24UL),
+                 static_cast<unsigned int>((uptimeSeconds / 60UL) % 60UL),
+                 static_cast<unsigned int>(uptimeSeconds % 60UL));
+        this->printLine(1U, buffer);
+    }
+
+    // Other private methods.
+
+    /// @brief Clears the display, and the lines shown on it.
+    void MyDisplay::clear(void) noexcept
+    {
+        this->peripheral_.clear();
+
+        for (uint8_t row = 0U; row < this->rows_; ++row)
+        {
+            memset(this->shownLines_[row], ' ', this->cols_);
+            this->shownLines_[row][this->cols_] = '\0';
+        }
+    }
+
+    /// @brief Prints the given line padded with spaces to the width of the display, so the
+    ///  previous contents are overwritten without clearing the display.
+    /// @param row the row to print the line on.
+    /// @param line the line.
+    void MyDisplay::printLine(uint8_t row, const char *line) noexcept
+    {
+        char padded[Cols + 1U];
+        uint8_t col = 0U;
+
+        for (; col < this->cols_ && line[col] != '\0'; ++col)
+            padded[col] = line[col];
+
+        for (; col < this->cols_; ++col)
+            padded[col] = ' ';
+
+        padded[col] = '\0';
+
+        // Finds the columns that differ from the line shown, and writes only those.
+        char *shown = this->shownLines_[row];
+        uint8_t first = 0U;
+        uint8_t last = this->cols_;
+
+        while (first < this->cols_ && padded[first] == shown[first])
+            ++first;
+
+        if (first == this->cols_)
+            return;
+
+        while (padded[last - 1U] == shown[last - 1U])
+            --last;
+
+        this->peripheral_.setCursor(first, row);
+
+        for (col = first; col < last; ++col)
+            this->peripheral_.print(padded[col]);
+
+        memcpy(shown, padded, sizeof(padded));
+    }
+
     // Current state methods.
 
     /// @brief Entry of the current state.
@@ -192,6 +354,80 @@ namespace lacar::droid_basestation::firmware
         }
     }
 
+    // Event methods.
+
+    /// @brief The static method to handle the given event.
+    /// @param u the user data (MyDisplay class instance).
+    /// @param event the event to handle.
+    void MyDisplay::staticHandleEvent(void *u, const MyEvents::Event &event) noexcept
+    {
+        // Casts the userdata back to a pointer of the class instance.
+        MyDisplay &instance = *reinterpret_cast<MyDisplay *>(u);
+
+        // Calls the handleEvent method.
+        instance.handleEvent(event);
+    }
+
+    /// @brief Handles the given event.
+    /// @param event the event to handle.
+    void MyDisplay::handleEvent(const MyEvents::Event &event) noexcept
+    {
+        switch (event.topic)
+        {
+        case MyEvents::Topic::StateChanged:
+            // Stores the new state for the overview and marks it as changed.
+            if (event.source == MyEvents::Source::GPS)
+            {
+                this->overviewStateData_.gpsState = event.data.stateChanged.state;
+                this->overviewStateData_.gpsErrorCause = event.data.stateChanged.errorCause;
+            }
+            else
+            {
+                this->overviewStateData_.comState = event.data.stateChanged.state;
+                this->overviewStateData_.comErrorCause = event.data.stateChanged.errorCause;
+            }
+
+            this->overviewStateData_.displayed = false;
+
+            // Shows the survey while the GPS is enabling, and the overview once it
+            //  has left the enabling state.
+            if (event.source == MyEvents::Source::GPS)
+            {
+                if (event.data.stateChanged.state == static_cast<uint8_t>(MyGPS::State::Enabling))
+                    this->transition(State::Survey);
+                else if (this->state_ == State::Survey)
+                    this->transition(State::Overview);
+            }
+            break;
+        case MyEvents::Topic::SurveyProgress:
+            // Stores the survey progress and marks it as changed.
+            this->surveyStateData_.meanAccuracy = event.data.surveyProgress.meanAccuracy;
+            this->surveyStateData_.elapsedObservationTime = event.data.surveyProgress.elapsedObservationTime;
+            this->surveyStateData_.displayed = false;
+            break;
+        case MyEvents::Topic::Throughput:
+        {
+            const uint32_t currentMillis = millis();
+            const uint32_t frames = MyGPS::getInstance().getFrames();
+            const uint32_t elapsedMillis = currentMillis - this->overviewStateData_.throughputMillis;
+
+            // Stores the throughput of the radio, and derives the received frames per second
+            //  over the same interval.
+            this->overviewStateData_.bytesPerSecond = event.data.throughput.bytesPerSecond;
+            this->overviewStateData_.chunksPerSecond = event.data.throughput.chunksPerSecond;
+            if (elapsedMillis != 0U)
+                this->overviewStateData_.framesPerSecond = static_cast<uint16_t>(
+                    ((frames - this->overviewStateData_.throughputFrames) * 1000UL) / elapsedMillis);
+
+            this->overviewStateData_.throughputFrames = frames;
+            this->overviewStateData_.throughputMillis = currentMillis;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
     /// @brief Transitions the display to the given state.
     /// @param state The state to transition to.
     void MyDisplay::transition(State state) noexcept
@@ -208,6 +444,12 @@ namespace lacar::droid_basestation::firmware
         this->peripheral_.init();
         this->peripheral_.backlight();
 
+        // Subscribes to the state changes, the survey progress and the throughput.
+        MyEvents::getInstance().subscribe(MyDisplay::staticHandleEvent, this,
+                                          MyEvents::topicBit(MyEvents::Topic::StateChanged) |
+                                              MyEvents::topicBit(MyEvents::Topic::SurveyProgress) |
+                                              MyEvents::topicBit(MyEvents::Topic::Throughput));
+
         // Enters the initial state.
         this->currentStateEntry();
     }
@@ -215,9 +457,16 @@ namespace lacar::droid_basestation::firmware
     /// @brief Performs the loop of the display.
     void MyDisplay::loop(void) noexcept
     {
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(DisplayLoop);
+
         const uint32_t currentMillis = millis();
 
-        if (currentMillis - this->lastUpdateMillis_ < 500)
+        if (currentMillis - this->lastUpdateMillis_ < LACAR_DROID_BASESTATION_FIRMWARE__DISPLAY__UPDATE_INTERVAL)
+            return;
+
+        // Only writes to the display when no epoch is being received or held for its slot,
+        //  the update follows right after.
+        if (!MyGPS::getInstance().isEpochBufferEmpty())
             return;
 
         this->currentStateDo();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <LiquidCrystal_I2C.h>
+#include "MyEvents.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
@@ -12,20 +13,40 @@ namespace lacar::droid_basestation::firmware
         struct SurveyStateData
         {
         public:
-            bool hasPreviousObservation;
-            float previousMeanAccuracy;
-            uint16_t previousObservationTime;
+            bool displayed;
+            float meanAccuracy;
+            uint16_t elapsedObservationTime;
+        };
+
+        /// @brief A page of the overview, the pages are shown in turn.
+        enum class Page : uint8_t
+        {
+            Status = 0,
+            Throughput = 1,
+            Drops = 2,
+            Satellites = 3,
+            Time = 4,
         };
 
+        /// @brief The number of overview pages.
+        static constexpr uint8_t PageCount = 5U;
+
         /// @brief The data of the overview state of the display.
         struct OverviewStateData
         {
         public:
             bool displayed;
+            Page page;
+            uint32_t pageSinceMillis;
             uint8_t gpsState;
             uint8_t comState;
             uint8_t gpsErrorCause;
             uint8_t comErrorCause;
+            uint16_t bytesPerSecond;
+            uint16_t chunksPerSecond;
+            uint16_t framesPerSecond;
+            uint32_t throughputFrames;
+            uint32_t throughputMillis;
         };
 
         /// @brief The state of the display.
@@ -36,6 +57,12 @@ namespace lacar::droid_basestation::firmware
             Overview = 2,
         };
 
+        /// @brief The number of rows of the display.
+        static constexpr uint8_t Rows = 2U;
+
+        /// @brief The number of columns of the display.
+        static constexpr uint8_t Cols = 16U;
+
     private:
         static MyDisplay s_Instance;
 
@@ -52,6 +79,7 @@ namespace lacar::droid_basestation::firmware
         OverviewStateData overviewStateData_;
         uint32_t lastUpdateMillis_;
         uint8_t rows_, cols_;
+        char shownLines_[Rows][Cols + 1U];
         LiquidCrystal_I2C peripheral_;
         State state_;
 
@@ -59,6 +87,14 @@ namespace lacar::droid_basestation::firmware
         /// @brief Constructs a new display instance.
         MyDisplay(void) noexcept;
 
+    public:
+        /// @brief Gets the current state.
+        /// @return the current state.
+        inline const State &getState(void) const noexcept
+        {
+            return this->state_;
+        }
+
     private:
         // Disabled state methods.
 
@@ -93,6 +129,33 @@ namespace lacar::droid_basestation::firmware
         /// @brief Exit of the overview state.
         void overviewExit(void) noexcept;
 
+        /// @brief Renders the page with the task states and error causes.
+        void overviewRenderStatus(void) noexcept;
+
+        /// @brief Renders the page with the correction throughput.
+        void overviewRenderThroughput(void) noexcept;
+
+        /// @brief Renders the page with the retried and dropped counters.
+        void overviewRenderDrops(void) noexcept;
+
+        /// @brief Renders the page with the satellites per constellation.
+        void overviewRenderSatellites(void) noexcept;
+
+        /// @brief Renders the page with the correction age and the uptime.
+        void overviewRenderTime(void) noexcept;
+
+        // Other private methods.
+
+        /// @brief Clears the display, and the lines shown on it.
+        void clear(void) noexcept;
+
+        /// @brief Prints the given line padded with spaces to the width of the display, so the
+        ///  previous contents are overwritten without clearing the display. Only the columns
+        ///  that differ from the line shown are written, an unchanged line costs no I2C.
+        /// @param row the row to print the line on.
+        /// @param line the line.
+        void printLine(uint8_t row, const char *line) noexcept;
+
         // Current state methods.
 
         /// @brief Entry of the current state.
@@ -104,6 +167,17 @@ namespace lacar::droid_basestation::firmware
         /// @brief Exit of the current state.
         void currentStateExit(void) noexcept;
 
+        // Event methods.
+
+        /// @brief The static method to handle the given event.
+        /// @param u the user data (MyDisplay class instance).
+        /// @param event the event to handle.
+        static void staticHandleEvent(void *u, const MyEvents::Event &event) noexcept;
+
+        /// @brief Handles the given event.
+        /// @param event the event to handle.
+        void handleEvent(const MyEvents::Event &event) noexcept;
+
     public:
         /// @brief Transitions the display to the given state.
         /// @param state The state to transition to.
@@ -0,0 +1,114 @@
+#include "MyEvents.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    MyEvents MyEvents::s_Instance;
+
+    /// @brief Constructs a new events instance.
+    MyEvents::MyEvents(void) noexcept
+        : queue_(),
+          subscribers_(),
+          queueHead_(0U),
+          queueCount_(0U),
+          subscriberCount_(0U),
+          droppedEvents_(0U)
+    {
+    }
+
+    /// @brief Subscribes the given callback to the topics in the mask.
+    /// @param callback the callback to call.
+    /// @param userData the user data passed to the callback.
+    /// @param topicMask the mask of topics (see topicBit).
+    /// @return false if there is no room for another subscriber.
+    bool MyEvents::subscribe(SubscriberCallback callback, void *userData, uint8_t topicMask) noexcept
+    {
+        // Makes sure there is room for the subscriber.
+        if (this->subscriberCount_ >= LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__MAX_SUBSCRIBERS)
+            return false;
+
+        // Stores the subscriber.
+        Subscriber &subscriber = this->subscribers_[this->subscriberCount_++];
+        subscriber.callback = callback;
+        subscriber.userData = userData;
+        subscriber.topicMask = topicMask;
+
+        return true;
+    }
+
+    /// @brief Queues the given event for delivery on the next loop.
+    /// @param event the event to publish.
+    void MyEvents::publish(const Event &event) noexcept
+    {
+        // Drops the event if the queue is full.
+        if (this->queueCount_ >= LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__QUEUE_SIZE)
+        {
+            ++this->droppedEvents_;
+            return;
+        }
+
+        // Writes the event at the tail of the queue.
+        const uint8_t tail = (this->queueHead_ + this->queueCount_) % LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__QUEUE_SIZE;
+        this->queue_[tail] = event;
+        ++this->queueCount_;
+    }
+
+    /// @brief Publishes a state change of the given source.
+    /// @param source the source of the change.
+    /// @param state the new state.
+    /// @param errorCause the error cause at the moment of the change.
+    void MyEvents::publishStateChanged(Source source, uint8_t state, uint8_t errorCause) noexcept
+    {
+        Event event;
+        event.topic = Topic::StateChanged;
+        event.source = source;
+        event.data.stateChanged.state = state;
+        event.data.stateChanged.errorCause = errorCause;
+        this->publish(event);
+    }
+
+    /// @brief Publishes an error of the given source.
+    /// @param source the source of the error.
+    /// @param errorCause the error cause.
+    void MyEvents::publishError(Source source, uint8_t errorCause) noexcept
+    {
+        Event event;
+        event.topic = Topic::Error;
+        event.source = source;
+        event.data.error.errorCause = errorCause;
+        this->publish(event);
+    }
+
+    /// @brief Performs the setup of the events.
+    void MyEvents::setup(void) noexcept
+    {
+        // Discards anything that was published before the setup.
+        this->queueHead_ = 0U;
+        this->queueCount_ = 0U;
+    }
+
+    /// @brief Delivers all the queued events to the subscribers.
+    void MyEvents::loop(void) noexcept
+    {
+        // Only delivers the events that were queued when the loop started, events
+        //  published by subscribers are delivered on the next loop.
+        uint8_t pending = this->queueCount_;
+
+        while (pending-- > 0U)
+        {
+            // Pops the event from the head of the queue.
+            const Event event = this->queue_[this->queueHead_];
+            this->queueHead_ = (this->queueHead_ + 1U) % LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__QUEUE_SIZE;
+            --this->queueCount_;
+
+            // Delivers the event to every subscriber interested in the topic.
+            const uint8_t bit = topicBit(event.topic);
+            for (uint8_t i = 0U; i < this->subscriberCount_; ++i)
+            {
+                const Subscriber &subscriber = this->subscribers_[i];
+
+                if ((subscriber.topicMask & bit) != 0U)
+                    subscriber.callback(subscriber.userData, event);
+            }
+        }
+    }
+}
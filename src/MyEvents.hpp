@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief A statically allocated publish/subscribe event queue between the subsystems.
+    class MyEvents
+    {
+    public:
+        /// @brief The subsystem that published an event.
+        enum class Source : uint8_t
+        {
+            GPS = 0,
+            Com = 1,
+        };
+
+        /// @brief The topic of an event.
+        enum class Topic : uint8_t
+        {
+            StateChanged = 0,
+            Error = 1,
+            SurveyProgress = 2,
+            Throughput = 3,
+        };
+
+        /// @brief A single event, the data union member is selected by the topic.
+        struct Event
+        {
+        public:
+            Topic topic;
+            Source source;
+            union
+            {
+                struct
+                {
+                    uint8_t state;
+                    uint8_t errorCause;
+                } stateChanged;
+
+                struct
+                {
+                    uint8_t errorCause;
+                } error;
+
+                struct
+                {
+                    uint16_t elapsedObservationTime;
+                    float meanAccuracy;
+                } surveyProgress;
+
+                struct
+                {
+                    uint16_t bytesPerSecond;
+                    uint16_t chunksPerSecond;
+                } throughput;
+            } data;
+        };
+
+        /// @brief The callback that gets called for every delivered event.
+        typedef void (*SubscriberCallback)(void *, const Event &);
+
+        /// @brief A single subscription.
+        struct Subscriber
+        {
+        public:
+            SubscriberCallback callback;
+            void *userData;
+            uint8_t topicMask;
+        };
+
+    private:
+        static MyEvents s_Instance;
+
+    public:
+        /// @brief Gets the current events instance.
+        /// @return The events instance.
+        static inline MyEvents &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+        /// @brief Gets the subscription mask bit of the given topic.
+        /// @param topic the topic.
+        /// @return the mask bit.
+        static inline constexpr uint8_t topicBit(Topic topic) noexcept
+        {
+            return static_cast<uint8_t>(1U << static_cast<uint8_t>(topic));
+        }
+
+    private:
+        Event queue_[LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__QUEUE_SIZE];
+        Subscriber subscribers_[LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__MAX_SUBSCRIBERS];
+        uint8_t queueHead_;
+        uint8_t queueCount_;
+        uint8_t subscriberCount_;
+        uint16_t droppedEvents_;
+
+    public:
+        /// @brief Constructs a new events instance.
+        MyEvents(void) noexcept;
+
+    public:
+        /// @brief Gets the number of events dropped because the queue was full.
+        /// @return the number of dropped events.
+        inline uint16_t getDroppedEvents(void) const noexcept
+        {
+            return this->droppedEvents_;
+        }
+
+        /// @brief Subscribes the given callback to the topics in the mask.
+        /// @param callback the callback to call.
+        /// @param userData the user data passed to the callback.
+        /// @param topicMask the mask of topics (see topicBit).
+        /// @return false if there is no room for another subscriber.
+        bool subscribe(SubscriberCallback callback, void *userData, uint8_t topicMask) noexcept;
+
+        /// @brief Queues the given event for delivery on the next loop.
+        /// @param event the event to publish.
+        void publish(const Event &event) noexcept;
+
+        /// @brief Publishes a state change of the given source.
+        /// @param source the source of the change.
+        /// @param state the new state.
+        /// @param errorCause the error cause at the moment of the change.
+        void publishStateChanged(Source source, uint8_t state, uint8_t errorCause) noexcept;
+
+        /// @brief Publishes an error of the given source.
+        /// @param source the source of the error.
+        /// @param errorCause the error cause.
+        void publishError(Source source, uint8_t errorCause) noexcept;
+
+        /// @brief Performs the setup of the events.
+        void setup(void) noexcept;
+
+        /// @brief Delivers all the queued events to the subscribers.
+        void loop(void) noexcept;
+    };
+}
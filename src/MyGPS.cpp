@@ -1,7 +1,9 @@
-#include "MyCom.hpp"
 #include "config.hpp"
 #include "MyGPS.hpp"
-#include "MyDisplay.hpp"
+#include "MyEvents.hpp"
+#include "MySchedule.hpp"
+#include "MyProfiler.hpp"
+#include "MyConsole.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
@@ -23,17 +25,20 @@ namespace lacar::droid_basestation::firmware
         this->processRTCMCallback_(this->processRTCMCallbackUserData_, byte);
     }
 
-    /// @brief Constructs an default config instance.
-    MyGPS::Config::Config(void) noexcept
-        : observationTime(300U),
-          requiredAccuracy(10.000f)
-    {
-    }
-
     /// @brief Constructs an empty enabling state data instance.
     MyGPS::EnablingStateData::EnablingStateData(void) noexcept
         : elapsedObservationTime(0),
-          meanAccuracy(0.0f)
+          meanAccuracy(0.0f),
+          lastRequestMillis(0U),
+          configured(false)
+    {
+    }
+
+    /// @brief Constructs an empty error state data instance.
+    MyGPS::ErrorStateData::ErrorStateData(void) noexcept
+        : backoff(LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__INITIAL_DELAY,
+                  LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_DELAY,
+                  LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_ATTEMPTS)
     {
     }
 
@@ -41,13 +46,74 @@ namespace lacar::droid_basestation::firmware
 
     /// @brief Constructs a new GPS instance.
     MyGPS::MyGPS(void) noexcept
-        : config_(),
+        : receiverConfig_(LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_ADDRESS),
+          requestSlots_(),
+          requests_(requestSlots_, LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_REQUESTS),
+          surveyStatusRequest_(UBXRequests::NoRequest),
           enablingStateData_(),
           enabledStateData_(),
+          epochBuffer_(enabledStateData_.epochBuffer, sizeof(enabledStateData_.epochBuffer),
+                       MyGPS::staticFlushEpoch, MyGPS::staticMayFlushEpoch, this),
+          poolBlocks_(),
+          pool_(poolBlocks_, LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS),
+          sinks_(),
+          fanout_(sinks_, LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_SINKS),
+          errorStateData_(),
+          ingestStatistics_(),
+          txReadyMicros_(0U),
+          txReady_(false),
+          lastPollMillis_(0U),
+          lastFlushMillis_(0U),
+          satellites_(),
           peripheral_(MyGPS::staticProcessRTCM, this),
+          recoveryCounts_(),
           state_(State::Disabled),
-          errorCause_(ErrorCause::Ok)
+          errorCause_(ErrorCause::Ok),
+          recoveringFrom_(ErrorCause::Ok)
+    {
+    }
+
+    /// @brief The interrupt handler of the TX-ready edge of the receiver.
+    void MyGPS::staticHandleTxReady(void) noexcept
+    {
+        // Keeps the time of the oldest edge that has not been serviced yet.
+        if (!s_Instance.txReady_)
+        {
+            s_Instance.txReadyMicros_ = micros();
+            s_Instance.txReady_ = true;
+        }
+    }
+
+    /// @brief The command that prints the ingest statistics.
+    void MyGPS::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+        static_cast<MyGPS *>(u)->printIngestStatistics();
+    }
+
+    /// @brief The command that prints the receiver configuration table.
+    void MyGPS::staticHandleConfigCommand(void *u, const char *arguments) noexcept
     {
+        (void)arguments;
+
+        const ReceiverConfig &receiverConfig = static_cast<MyGPS *>(u)->receiverConfig_;
+
+        Serial.print(F("RXCFG version="));
+        Serial.print(LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION);
+        Serial.print(F(" entries="));
+        Serial.println(receiverConfig.getEntryCount());
+
+        for (uint8_t i = 0U; i < receiverConfig.getEntryCount(); ++i)
+        {
+            const ReceiverConfig::Entry entry = receiverConfig.getEntry(i);
+
+            Serial.print(F("KEY 0x"));
+            Serial.print(entry.key, HEX);
+            Serial.print(F(" value="));
+            Serial.print(entry.value);
+            Serial.print(F(" stage="));
+            Serial.println(static_cast<uint8_t>(entry.stage));
+        }
     }
 
     // Disabled state.
@@ -72,62 +138,94 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the enabling state.
     void MyGPS::enablingEntry(void) noexcept
     {
-        // Begins the driver (stupid method name).
-        if (!this->peripheral_.begin())
+        // Begins the driver.
+        const ErrorCause errorCause = this->beginPeripheral();
+        if (errorCause != ErrorCause::Ok)
         {
-            this->errorCause_ = ErrorCause::PeripheralBeginFailed;
+            this->errorCause_ = errorCause;
             this->transition(State::Error);
             return;
         }
 
-        // Sets the I2C output of the module.
-        if (!this->peripheral_.setI2COutput(COM_TYPE_UBX | COM_TYPE_NMEA | COM_TYPE_RTCM3))
+        // The receiver is configured once the first survey status tells whether it is surveying.
+        this->enablingStateData_.configured = false;
+        this->enablingStateData_.lastRequestMillis = millis();
+        this->requests_.issue(this->surveyStatusRequest_);
+    }
+
+    /// @brief Do of the enabling state.
+    void MyGPS::enablingDo(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Reads whatever the receiver has pending, the responses are stored by the driver.
         {
-            this->errorCause_ = ErrorCause::PeripheralSetI2COutputFailed;
-            this->transition(State::Error);
+            LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(GPSCheckUblox);
+            this->peripheral_.checkUblox();
+        }
+
+        // Completes the polls that were answered or timed out, which may leave this state.
+        this->requests_.loop();
+        if (this->state_ != State::Enabling)
             return;
+
+        // Polls the survey status again once the interval has elapsed.
+        if (!this->requests_.isPending(this->surveyStatusRequest_) &&
+            currentMillis - this->enablingStateData_.lastRequestMillis >= LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_STATUS_INTERVAL)
+        {
+            this->enablingStateData_.lastRequestMillis = currentMillis;
+            this->requests_.issue(this->surveyStatusRequest_);
         }
+    }
 
-        // Gets the survey status.
-        if (!this->peripheral_.getSurveyStatus())
+    /// @brief Configures the receiver on the first survey status, and enables the stream
+    ///  once the survey is valid.
+    /// @param received false if the poll timed out.
+    void MyGPS::enablingHandleSurveyStatus(bool received) noexcept
+    {
+        if (!received)
         {
-            this->errorCause_ = ErrorCause::PeripheralGetSurveyStatusFailed;
+            this->errorCause_ = this->enablingStateData_.configured ? ErrorCause::PeripheralSvinStatusRequestFailed
+                                                                    : ErrorCause::PeripheralGetSurveyStatusFailed;
             this->transition(State::Error);
             return;
         }
 
-        // Check if survey mode has not been enabled yet.
-        if (!this->peripheral_.getSurveyInActive())
+        const UBX_NAV_SVIN_data_t &svin = this->peripheral_.packetUBXNAVSVIN->data;
+
+        // Configures the output, and starts the survey if there is no valid or running one
+        //  yet, in one VALSET. The next status tells how the survey is doing. A recovery
+        //  finds the survey still valid, and re-applies the output and the stream in one
+        //  VALSET instead.
+        if (!this->enablingStateData_.configured)
         {
-            // Gets the required configuration parameters.
-            const uint16_t &observationTime = this->config_.observationTime;
-            const float &requiredAccuracy = this->config_.requiredAccuracy;
+            uint8_t stageMask = ReceiverConfig::stageBit(ReceiverConfig::Stage::Output);
+            if (svin.valid != 0)
+                stageMask |= ReceiverConfig::stageBit(ReceiverConfig::Stage::Stream);
+            else if (svin.active == 0)
+                stageMask |= ReceiverConfig::stageBit(ReceiverConfig::Stage::Survey);
 
-            // Enable survey mode with the parameters.
-            if (!this->peripheral_.enableSurveyMode(observationTime, requiredAccuracy))
+            if (!this->receiverConfig_.apply(this->peripheral_, stageMask))
             {
-                this->errorCause_ = ErrorCause::PeripheralEnableSurveyModeFailed;
+                this->errorCause_ = ErrorCause::PeripheralApplyConfigFailed;
                 this->transition(State::Error);
                 return;
             }
-        }
 
-        // Puts the display in surveying mode.
-        MyDisplay::getInstance().transition(MyDisplay::State::Survey);
-    }
+            this->enablingStateData_.configured = true;
+
+            if (svin.valid != 0)
+                this->transition(State::Enabled);
+
+            return;
+        }
 
-    /// @brief Do of the enabling state.
-    void MyGPS::enablingDo(void) noexcept
-    {
         // If the survey is valid then perform final configuration and transition to
         //  enabled state.
-        if (this->peripheral_.getSurveyInValid())
+        if (svin.valid != 0)
         {
             // Enables the RTCM messages on the I2C port.
-            if (!this->peripheral_.enableRTCMmessage(UBX_RTCM_1005, COM_PORT_I2C, 1) ||
-                !this->peripheral_.enableRTCMmessage(UBX_RTCM_1077, COM_PORT_I2C, 1) ||
-                !this->peripheral_.enableRTCMmessage(UBX_RTCM_1087, COM_PORT_I2C, 1) ||
-                !this->peripheral_.enableRTCMmessage(UBX_RTCM_1230, COM_PORT_I2C, 10))
+            if (!this->receiverConfig_.apply(this->peripheral_, ReceiverConfig::stageBit(ReceiverConfig::Stage::Stream)))
             {
                 this->errorCause_ = ErrorCause::PeripheralEnableRTCMMessagesFailed;
                 this->transition(State::Error);
@@ -139,26 +237,25 @@ namespace lacar::droid_basestation::firmware
             return;
         }
 
-        // Requests the SVIN status.
-        if (!this->peripheral_.getSurveyStatus())
-        {
-            this->errorCause_ = ErrorCause::PeripheralSvinStatusRequestFailed;
-            this->transition(State::Error);
-            return;
-        }
-
-        // Gets the elapsed observation time and the mean accuraccy and puts them
-        //  in the enabled state data. Unfortunately the designers of this library
-        //  are retards, and did not make it possible to check whether or not these
-        //  values are correct.
-        this->enablingStateData_.elapsedObservationTime = this->peripheral_.getSurveyInObservationTime();
-        this->enablingStateData_.meanAccuracy = this->peripheral_.getSurveyInMeanAccuracy();
+        // Puts the elapsed observation time and the mean accuracy (in 0.1 mm) in the
+        //  enabling state data.
+        this->enablingStateData_.elapsedObservationTime = static_cast<uint16_t>(min(svin.dur, 65535UL));
+        this->enablingStateData_.meanAccuracy = static_cast<float>(svin.meanAcc) / 10000.0f;
+
+        // Publishes the survey progress.
+        MyEvents::Event event;
+        event.topic = MyEvents::Topic::SurveyProgress;
+        event.source = MyEvents::Source::GPS;
+        event.data.surveyProgress.elapsedObservationTime = this->enablingStateData_.elapsedObservationTime;
+        event.data.surveyProgress.meanAccuracy = this->enablingStateData_.meanAccuracy;
+        MyEvents::getInstance().publish(event);
     }
 
     /// @brief Exit of the enabling state.
     void MyGPS::enablingExit(void) noexcept
     {
-        MyDisplay::getInstance().transition(MyDisplay::State::Overview);
+        // A late response must not complete a poll of the next enabling.
+        this->requests_.cancel();
     }
 
     // Enabled state.
@@ -166,21 +263,88 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the enabled state.
     void MyGPS::enabledEntry(void) noexcept
     {
-        // Resets the buffer index for the RTCM messages.
-        this->enabledStateData_.rtcmBufferIdx = 0U;
+        // We're enabled again, so count the recovery if there was one, and give
+        //  the next error the full retry budget.
+        if (this->recoveringFrom_ != ErrorCause::Ok)
+        {
+            ++this->recoveryCounts_[static_cast<uint8_t>(this->recoveringFrom_)];
+            this->recoveringFrom_ = ErrorCause::Ok;
+        }
+
+        this->errorStateData_.backoff.reset();
+
+        // Empties the epoch buffer and waits for the next frame.
+        this->epochBuffer_.reset();
     }
 
     /// @brief Do of the enabled state.
     void MyGPS::enabledDo(void) noexcept
     {
+        IngestStatistics &statistics = this->ingestStatistics_;
+        const uint32_t pollMillis = millis();
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED
+
+        // Takes the pending edge atomically.
+        noInterrupts();
+        const bool txReady = this->txReady_;
+        const uint32_t txReadyMicros = this->txReadyMicros_;
+        this->txReady_ = false;
+        interrupts();
+
+        // Keeps reading while a burst is coming in, its tail may stay below the threshold of
+        //  the pin. Otherwise the receiver is only read when it signals pending data, and now
+        //  and then in case an edge was missed.
+        const bool inBurst = pollMillis - this->enabledStateData_.lastByteMillis <= LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_FLUSH_AFTER;
+        const bool fallback = pollMillis - this->lastPollMillis_ >= LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_POLL_INTERVAL;
+        const bool poll = txReady || inBurst || fallback ||
+                          digitalRead(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_PIN) == HIGH;
+
+        if (txReady)
+            ++statistics.txReadyEdges;
+        else if (fallback && !inBurst)
+            ++statistics.fallbackPolls;
+        else if (!poll)
+            ++statistics.skippedPolls;
+#else
+        const bool poll = true;
+#endif
+
+        if (poll)
+        {
+            ++statistics.polls;
+            this->lastPollMillis_ = pollMillis;
+
+            // Performs the updating of the GPS module (stupid name).
+            {
+                LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(GPSCheckUblox);
+                this->peripheral_.checkUblox();
+            }
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED
+            // Measures the time from the edge until its data has been read.
+            if (txReady)
+            {
+                const uint32_t latencyMicros = micros() - txReadyMicros;
+
+                ++statistics.latencyCount;
+                statistics.totalLatencyMicros += latencyMicros;
+                if (latencyMicros > statistics.maxLatencyMicros)
+                    statistics.maxLatencyMicros = latencyMicros;
+            }
+#endif
+        }
+
+        // Takes the time after the update, which may have received bytes.
         const uint32_t currentMillis = millis();
 
-        // Performs the updating of the GPS module (stupid name).
-        this->peripheral_.checkUblox();
+        // The complete frames are ready if no bytes arrived for a given time, the epoch
+        //  is not going to be completed by an MSM.
+        if (currentMillis - this->enabledStateData_.lastByteMillis > LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_FLUSH_AFTER)
+            this->epochBuffer_.markReady();
 
-        // Flush the RTCM buffer if a given time has passed.
-        if (this->enabledStateData_.rtcmBufferIdx > 0U && currentMillis - this->enabledStateData_._rtcmBufferWritingSince > LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_FLUSH_AFTER)
-            this->enabledFlushRTCMBuffer();
+        // Flushes the ready epoch once the correction slot comes around.
+        this->epochBuffer_.tryFlush();
     }
 
     /// @brief Exit of the enabled state.
@@ -188,18 +352,108 @@ namespace lacar::droid_basestation::firmware
     {
     }
 
-    /// @brief Flushes the RTCM buffer.
-    void MyGPS::enabledFlushRTCMBuffer(void) noexcept
+    /// @brief The static method to deliver a flushed epoch to the sinks.
+    /// @param u the user data (MyGPS class instance).
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    void MyGPS::staticFlushEpoch(void *u, const uint8_t *epoch, uint16_t epochSize) noexcept
+    {
+        MyGPS &gps = *static_cast<MyGPS *>(u);
+
+        // Counts the epoch for the gps command, printing it here would delay the burst.
+        IngestStatistics &statistics = gps.ingestStatistics_;
+        ++statistics.flushedEpochs;
+        statistics.flushedBytes += epochSize;
+        if (epochSize > statistics.maxEpochSize)
+            statistics.maxEpochSize = epochSize;
+
+        gps.lastFlushMillis_ = millis();
+
+        // Stores the epoch once, so the sinks that send it later can share it without a copy.
+        const RTCMFramePool::Handle handle = gps.pool_.store(epoch, epochSize);
+
+        // Hands the epoch to every sink, the radio first.
+        gps.fanout_.deliver(epoch, epochSize, handle);
+
+        // Drops our reference, the frame stays in the pool as long as a sink holds it.
+        if (handle != RTCMFramePool::NoBlock)
+            gps.pool_.release(handle);
+    }
+
+    /// @brief The static method to check whether a ready epoch may be sent.
+    /// @param u the user data (MyGPS class instance).
+    /// @return true if we're in a correction slot.
+    bool MyGPS::staticMayFlushEpoch(void *u) noexcept
+    {
+        (void)u;
+
+        // Holds the epoch until the correction slot comes around.
+        return MySchedule::getInstance().isCorrectionSlot();
+    }
+
+    /// @brief Sends the NAV-SVIN poll without waiting for the response.
+    /// @param u the user data (MyGPS class instance).
+    void MyGPS::staticSendSurveyStatus(void *u) noexcept
+    {
+        // Without a wait the driver only sends the poll, it allocates the NAV-SVIN storage
+        //  the first time, and fills it when checkUblox reads the response.
+        static_cast<MyGPS *>(u)->peripheral_.getSurveyStatus(0U);
+    }
+
+    /// @brief Checks whether the driver stored a NAV-SVIN, and consumes it.
+    /// @param u the user data (MyGPS class instance).
+    /// @return true if a NAV-SVIN was received.
+    bool MyGPS::staticReceivedSurveyStatus(void *u) noexcept
     {
-        Serial.print("Flushing RTCM buffer of size ");
-        Serial.println(this->enabledStateData_.rtcmBufferIdx);
+        UBX_NAV_SVIN_t *svin = static_cast<MyGPS *>(u)->peripheral_.packetUBXNAVSVIN;
 
-        // Writes the stream chunk.
-        MyCom::getInstance().writeRTCMStreamChunk(this->enabledStateData_.rtcmBuffer,
-                                                  this->enabledStateData_.rtcmBufferIdx);
+        if (svin == nullptr || svin->moduleQueried.moduleQueried.bits.all == 0U)
+            return false;
 
-        // Resets the buffer index.
-        this->enabledStateData_.rtcmBufferIdx = 0;
+        svin->moduleQueried.moduleQueried.all = 0U;
+        return true;
+    }
+
+    /// @brief Handles the completed NAV-SVIN poll.
+    /// @param u the user data (MyGPS class instance).
+    /// @param received false if the poll timed out.
+    void MyGPS::staticCompleteSurveyStatus(void *u, bool received) noexcept
+    {
+        MyGPS &gps = *static_cast<MyGPS *>(u);
+
+        if (gps.state_ == State::Enabling)
+            gps.enablingHandleSurveyStatus(received);
+    }
+
+    /// @brief The command that prints the counters of the sinks and the frame pool.
+    void MyGPS::staticHandleSinksCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+
+        const RTCMFanout &fanout = static_cast<MyGPS *>(u)->fanout_;
+        const RTCMFramePool &pool = static_cast<MyGPS *>(u)->pool_;
+        const RTCMFramePool::Statistics &statistics = pool.getStatistics();
+
+        Serial.print(F("POOL free="));
+        Serial.print(pool.getFreeBlocks());
+        Serial.print(F(" min_free="));
+        Serial.print(statistics.minFreeBlocks);
+        Serial.print(F(" stored="));
+        Serial.print(statistics.stored);
+        Serial.print(F(" failed="));
+        Serial.println(statistics.failed);
+
+        for (uint8_t i = 0U; i < fanout.getSinkCount(); ++i)
+        {
+            const RTCMFanout::Sink &sink = fanout.getSink(i);
+
+            Serial.print(F("SINK "));
+            Serial.print(sink.name);
+            Serial.print(F(" delivered="));
+            Serial.print(sink.deliveredEpochs);
+            Serial.print(F(" dropped="));
+            Serial.println(sink.droppedEpochs);
+        }
     }
 
     // Error state.
@@ -207,11 +461,41 @@ namespace lacar::droid_basestation::firmware
     /// @brief Entry of the error state.
     void MyGPS::errorEntry(void) noexcept
     {
+        // Publishes the error.
+        MyEvents::getInstance().publishError(MyEvents::Source::GPS,
+                                             static_cast<uint8_t>(this->errorCause_));
+
+        // Waits before the next recovery attempt.
+        this->errorStateData_.backoff.start(millis());
+
+        if (this->errorStateData_.backoff.isExhausted())
+            Serial.println(F("GPS recovery failed, giving up"));
     }
 
     /// @brief Do of the error state.
     void MyGPS::errorDo(void) noexcept
     {
+        const uint32_t currentMillis = millis();
+        Backoff &backoff = this->errorStateData_.backoff;
+
+        // Don't attempt recovery until the backoff has elapsed, or ever again
+        //  once the retry budget has been used up.
+        if (!backoff.isDue(currentMillis))
+            return;
+
+        backoff.next();
+
+        Serial.print(F("GPS recovery attempt "));
+        Serial.println(backoff.getAttempts());
+
+        // Remembers what we're recovering from, it's counted once we're enabled.
+        if (this->recoveringFrom_ == ErrorCause::Ok)
+            this->recoveringFrom_ = this->errorCause_;
+
+        // Starts over from the enabling state, which comes back here if it fails. It keeps
+        //  the survey if the receiver still has a valid one, and redoes it otherwise.
+        this->errorCause_ = ErrorCause::Ok;
+        this->transition(State::Enabling);
     }
 
     /// @brief Exit of the error state.
@@ -289,6 +573,75 @@ namespace lacar::droid_basestation::firmware
 
     // Other private method.
 
+    /// @brief Begins the peripheral and the driver settings, the receiver itself is
+    ///  configured from the receiver configuration table.
+    /// @return the cause of the failure, or Ok.
+    MyGPS::ErrorCause MyGPS::beginPeripheral(void) noexcept
+    {
+        // Begins the driver (stupid method name).
+        if (!this->peripheral_.begin())
+            return ErrorCause::PeripheralBeginFailed;
+
+        // Reads the stream in transactions as large as the I2C buffer of the core allows.
+        this->peripheral_.setI2CTransactionSize(LACAR_DROID_BASESTATION_FIRMWARE__GPS__I2C_TRANSACTION_SIZE);
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED
+        // The pin tells when to read, so the driver may read again shortly after the last read.
+        this->peripheral_.setI2CpollingWait(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_POLLING_WAIT);
+#endif
+
+        return ErrorCause::Ok;
+    }
+
+    /// @brief Prints the ingest statistics to the serial port.
+    void MyGPS::printIngestStatistics(void) noexcept
+    {
+        const IngestStatistics &statistics = this->ingestStatistics_;
+
+        Serial.print(F("GPS bytes="));
+        Serial.print(statistics.bytes);
+        Serial.print(F(" polls="));
+        Serial.print(statistics.polls);
+        Serial.print(F(" skipped="));
+        Serial.print(statistics.skippedPolls);
+        Serial.print(F(" txready="));
+        Serial.print(statistics.txReadyEdges);
+        Serial.print(F(" fallback="));
+        Serial.print(statistics.fallbackPolls);
+        Serial.print(F(" epochs="));
+        Serial.print(statistics.flushedEpochs);
+        Serial.print(F(" epoch_size="));
+        Serial.print(statistics.flushedEpochs > 0U ? statistics.flushedBytes / statistics.flushedEpochs : 0U);
+        Serial.print(F("/"));
+        Serial.print(statistics.maxEpochSize);
+        Serial.print(F(" forced_flushes="));
+        Serial.print(this->epochBuffer_.getForcedFlushes());
+        Serial.print(F(" latency="));
+        Serial.print(statistics.latencyCount > 0U ? statistics.totalLatencyMicros / statistics.latencyCount : 0U);
+        Serial.print(F("/"));
+        Serial.print(statistics.maxLatencyMicros);
+        Serial.println(F("us"));
+
+        for (uint8_t i = 0U; i < this->requests_.getRequestCount(); ++i)
+        {
+            const UBXRequests::Request &request = this->requests_.getRequest(i);
+
+            Serial.print(F("UBX "));
+            Serial.print(request.name);
+            Serial.print(F(" issued="));
+            Serial.print(request.issued);
+            Serial.print(F(" completed="));
+            Serial.print(request.completed);
+            Serial.print(F(" timed_out="));
+            Serial.print(request.timedOut);
+            Serial.print(F(" latency="));
+            Serial.print(request.completed > 0U ? request.totalLatencyMillis / request.completed : 0U);
+            Serial.print(F("/"));
+            Serial.print(request.maxLatencyMillis);
+            Serial.println(F("ms"));
+        }
+    }
+
     /// @brief The static method to process the given byte.
     /// @param u the user data (MyGPS class instance).
     /// @param byte the byte to process.
@@ -305,19 +658,24 @@ namespace lacar::droid_basestation::firmware
     /// @param byte The byte to process.
     void MyGPS::processRTCM(uint8_t byte)
     {
-        // Stores the start of the write time if this is the first write to the buffer.
-        if (this->enabledStateData_.rtcmBufferIdx == 0)
-            this->enabledStateData_._rtcmBufferWritingSince = millis();
+        ++this->ingestStatistics_.bytes;
 
-        // Writes the byte to the RTCM buffer.
-        this->enabledStateData_.rtcmBuffer[this->enabledStateData_.rtcmBufferIdx++] = byte;
+        const uint32_t frames = this->epochBuffer_.getFrames();
 
-        // Don't flush the buffer if it's not full yet.
-        if (this->enabledStateData_.rtcmBufferIdx < LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_SIZE)
+        // Adds the byte to the epoch, which is flushed when it completes.
+        if (!this->epochBuffer_.push(byte))
             return;
 
-        // Flush the buffer.
-        this->enabledFlushRTCMBuffer();
+        this->enabledStateData_.lastByteMillis = millis();
+
+        // Keeps the satellite count of every constellation from its MSMs.
+        const RTCMParser::Frame &frame = this->epochBuffer_.getParser().getFrame();
+        if (this->epochBuffer_.getFrames() != frames && frame.msm)
+        {
+            const uint8_t constellation = RTCMParser::getMSMConstellation(frame.messageNumber);
+            if (constellation < ConstellationCount)
+                this->satellites_[constellation] = frame.satellites;
+        }
     }
 
     /// @brief Transitions to the given state.
@@ -326,6 +684,13 @@ namespace lacar::droid_basestation::firmware
     {
         this->currentStateExit();
         this->state_ = state;
+
+        // Publishes the state change before the entry, so that transitions made
+        //  by the entry are published in order.
+        MyEvents::getInstance().publishStateChanged(MyEvents::Source::GPS,
+                                                    static_cast<uint8_t>(this->state_),
+                                                    static_cast<uint8_t>(this->errorCause_));
+
         this->currentStateEntry();
     }
 
@@ -342,9 +707,58 @@ namespace lacar::droid_basestation::firmware
         this->transition(State::Enabling);
     }
 
+    /// @brief Gets the number of epochs dropped by all the sinks together.
+    /// @return the number of dropped epochs.
+    uint32_t MyGPS::getDroppedEpochs(void) const noexcept
+    {
+        uint32_t droppedEpochs = 0U;
+
+        for (uint8_t i = 0U; i < this->fanout_.getSinkCount(); ++i)
+            droppedEpochs += this->fanout_.getSink(i).droppedEpochs;
+
+        return droppedEpochs;
+    }
+
+    /// @brief Registers a sink of the RTCM epochs, the sinks registered first are served first.
+    /// @param name the name of the sink.
+    /// @param writeCallback the callback that writes an epoch to the sink.
+    /// @param capacityCallback the callback that reports the capacity, or null if the sink
+    ///  accepts everything.
+    /// @param userData the user data passed to the callbacks.
+    /// @return false if there is no room for another sink.
+    bool MyGPS::addSink(const char *name, RTCMFanout::WriteCallback writeCallback,
+                        RTCMFanout::CapacityCallback capacityCallback, void *userData) noexcept
+    {
+        return this->fanout_.addSink(name, writeCallback, capacityCallback, userData);
+    }
+
     /// @brief performs all the setup for the GPS.
     void MyGPS::setup(void) noexcept
     {
+#if LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED
+        // Captures the rising edge of the TX-ready pin of the receiver.
+        pinMode(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_PIN),
+                        MyGPS::staticHandleTxReady, RISING);
+#endif
+
+        // Registers the polls that are answered asynchronously.
+        this->surveyStatusRequest_ = this->requests_.add("NAV-SVIN", MyGPS::staticSendSurveyStatus,
+                                                         MyGPS::staticReceivedSurveyStatus,
+                                                         MyGPS::staticCompleteSurveyStatus,
+                                                         LACAR_DROID_BASESTATION_FIRMWARE__GPS__REQUEST_TIMEOUT, this);
+
+        // Checks the stored receiver configuration, the defaults replace an outdated one.
+        if (this->receiverConfig_.load())
+            Serial.println(F("GPS receiver configuration written to EEPROM"));
+
+        MyConsole::getInstance().registerCommand(F("rxcfg"), F("prints the receiver configuration table"),
+                                                 MyGPS::staticHandleConfigCommand, this);
+        MyConsole::getInstance().registerCommand(F("gps"), F("prints the polls, TX-ready edges and ingest latency"),
+                                                 MyGPS::staticHandleCommand, this);
+        MyConsole::getInstance().registerCommand(F("sinks"), F("prints the delivered and dropped epochs per RTCM sink, and the frame pool"),
+                                                 MyGPS::staticHandleSinksCommand, this);
+
         // Performs the entry of the initial state.
         this->currentStateEntry();
     }
@@ -352,6 +766,8 @@ namespace lacar::droid_basestation::firmware
     /// @brief performs all the processing for the GPS.
     void MyGPS::loop(void) noexcept
     {
+        LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(GPSLoop);
+
         // Performs the do of the current state.
         this->currentStateDo();
     }
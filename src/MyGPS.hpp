@@ -1,7 +1,14 @@
 #pragma once
 
 #include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <DroidProtocol.hpp>
 #include "config.hpp"
+#include "Backoff.hpp"
+#include "RTCMEpochBuffer.hpp"
+#include "RTCMFanout.hpp"
+#include "RTCMFramePool.hpp"
+#include "ReceiverConfig.hpp"
+#include "UBXRequests.hpp"
 
 namespace lacar::droid_basestation::firmware
 {
@@ -31,24 +38,14 @@ namespace lacar::droid_basestation::firmware
     class MyGPS
     {
     public:
-        /// @brief The configuration for the GPS.
-        struct Config
-        {
-        public:
-            const uint16_t observationTime;
-            const float requiredAccuracy;
-
-        public:
-            /// @brief Constructs an default config instance.
-            Config(void) noexcept;
-        };
-
         /// @brief The data of the enabling state.
         struct EnablingStateData
         {
         public:
             uint16_t elapsedObservationTime;
             float meanAccuracy;
+            uint32_t lastRequestMillis;
+            bool configured;
 
         public:
             /// @brief Constructs an empty enabling state data instance.
@@ -59,9 +56,36 @@ namespace lacar::droid_basestation::firmware
         struct EnabledStateData
         {
         public:
-            uint32_t _rtcmBufferWritingSince;
-            uint8_t rtcmBuffer[LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_SIZE];
-            uint8_t rtcmBufferIdx;
+            uint32_t lastByteMillis;
+            uint8_t epochBuffer[LACAR_DROID_BASESTATION_FIRMWARE__GPS__EPOCH_BUFFER_SIZE];
+        };
+
+        /// @brief The statistics of reading the stream from the receiver.
+        struct IngestStatistics
+        {
+        public:
+            uint32_t bytes;
+            uint32_t polls;
+            uint32_t skippedPolls;
+            uint32_t txReadyEdges;
+            uint32_t fallbackPolls;
+            uint32_t latencyCount;
+            uint32_t totalLatencyMicros;
+            uint32_t maxLatencyMicros;
+            uint32_t flushedEpochs;
+            uint32_t flushedBytes;
+            uint16_t maxEpochSize;
+        };
+
+        /// @brief The data of the error state.
+        struct ErrorStateData
+        {
+        public:
+            Backoff backoff;
+
+        public:
+            /// @brief Constructs an empty error state data instance.
+            ErrorStateData(void) noexcept;
         };
 
         /// @brief The cause of an error in the GPS.
@@ -69,14 +93,37 @@ namespace lacar::droid_basestation::firmware
         {
             Ok = 0,
             PeripheralBeginFailed = 1,
-            PeripheralSetI2COutputFailed = 2,
             PeripheralGetSurveyStatusFailed = 3,
-            PeripheralEnableSurveyModeFailed = 4,
             PeripheralSvinStatusRequestFailed = 5,
             PeripheralEnableRTCMMessagesFailed = 6,
             PeripheralCheckUbloxFailed = 7,
+            PeripheralApplyConfigFailed = 9,
         };
 
+        /// @brief The number of error causes, including Ok and the retired causes 2, 4 and 8 (the
+        ///  I2C output, survey mode and TX-ready are configured with the rest now), the codes
+        ///  stay stable so that a code on the display keeps its meaning.
+        static constexpr uint8_t ErrorCauseCount = 10U;
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS < RTCMFramePool::NoBlock,
+                      "The blocks of the frame pool must be addressable by an 8-bit index");
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__GPS__EPOCH_BUFFER_SIZE <= protocol::MaxEpochSize,
+                      "The rovers that check the tags hold at most MaxEpochSize bytes of an epoch");
+
+        /// @brief The number of blocks a full epoch takes in the frame pool.
+        static constexpr uint16_t EpochPoolBlocks =
+            (LACAR_DROID_BASESTATION_FIRMWARE__GPS__EPOCH_BUFFER_SIZE + RTCMFramePool::BlockSize - 1U) / RTCMFramePool::BlockSize;
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS >=
+                          EpochPoolBlocks * (2U + LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED *
+                                                      LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE),
+                      "The frame pool must hold the next epoch while the repair cache holds the previous one, "
+                      "and every epoch in the serial output queue");
+
+        /// @brief The number of constellations with MSMs (GPS, GLONASS, Galileo, SBAS, QZSS, BeiDou).
+        static constexpr uint8_t ConstellationCount = 6U;
+
         /// @brief The state of the GPS.
         enum class State : uint8_t
         {
@@ -98,12 +145,39 @@ namespace lacar::droid_basestation::firmware
         }
 
     private:
-        Config config_;
+        /// @brief The interrupt handler of the TX-ready edge of the receiver.
+        static void staticHandleTxReady(void) noexcept;
+
+        /// @brief The command that prints the ingest statistics.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+        /// @brief The command that prints the receiver configuration table.
+        static void staticHandleConfigCommand(void *u, const char *arguments) noexcept;
+
+    private:
+        ReceiverConfig receiverConfig_;
+        UBXRequests::Request requestSlots_[LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_REQUESTS];
+        UBXRequests requests_;
+        UBXRequests::Handle surveyStatusRequest_;
         EnablingStateData enablingStateData_;
         EnabledStateData enabledStateData_;
+        RTCMEpochBuffer epochBuffer_;
+        RTCMFramePool::Block poolBlocks_[LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS];
+        RTCMFramePool pool_;
+        RTCMFanout::Sink sinks_[LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_SINKS];
+        RTCMFanout fanout_;
+        ErrorStateData errorStateData_;
+        IngestStatistics ingestStatistics_;
+        volatile uint32_t txReadyMicros_;
+        volatile bool txReady_;
+        uint32_t lastPollMillis_;
+        uint32_t lastFlushMillis_;
+        uint8_t satellites_[ConstellationCount];
         SFE_UBLOX_GNSS_Ext peripheral_;
+        uint16_t recoveryCounts_[ErrorCauseCount];
         State state_;
         ErrorCause errorCause_;
+        ErrorCause recoveringFrom_;
 
     public:
         /// @brief Constructs a new GPS instance.
@@ -117,11 +191,73 @@ namespace lacar::droid_basestation::firmware
             return this->state_;
         }
 
+        /// @brief Gets whether no epoch is being received or waiting to be sent.
+        /// @return true if the epoch buffer is empty.
+        inline bool isEpochBufferEmpty(void) const noexcept
+        {
+            return this->epochBuffer_.getBufferSize() == 0U;
+        }
+
         inline const ErrorCause &getErrorCause(void) const noexcept
         {
             return this->errorCause_;
         }
 
+        /// @brief Gets the number of valid RTCM frames received.
+        /// @return the number of frames.
+        inline uint32_t getFrames(void) const noexcept
+        {
+            return this->epochBuffer_.getFrames();
+        }
+
+        /// @brief Gets the number of RTCM frames dropped because they did not fit in the epoch buffer.
+        /// @return the number of dropped frames.
+        inline uint16_t getDroppedFrames(void) const noexcept
+        {
+            return this->epochBuffer_.getDroppedFrames();
+        }
+
+        /// @brief Gets the time of the last flushed epoch, the age of the corrections.
+        /// @return the time of the last flush, zero if nothing has been flushed yet.
+        inline uint32_t getLastFlushMillis(void) const noexcept
+        {
+            return this->lastFlushMillis_;
+        }
+
+        /// @brief Gets the number of satellites in the last MSM of the given constellation.
+        /// @param constellation the constellation, see RTCMParser::getMSMConstellation.
+        /// @return the number of satellites.
+        inline uint8_t getSatellites(uint8_t constellation) const noexcept
+        {
+            return this->satellites_[constellation];
+        }
+
+        /// @brief Gets the number of epochs dropped by all the sinks together.
+        /// @return the number of dropped epochs.
+        uint32_t getDroppedEpochs(void) const noexcept;
+
+        /// @brief Gets the pool that holds the flushed epochs, for the sinks that retain them.
+        /// @return the frame pool.
+        inline RTCMFramePool &getFramePool(void) noexcept
+        {
+            return this->pool_;
+        }
+
+        /// @brief Gets the number of recoveries from the given error cause.
+        /// @param errorCause the error cause.
+        /// @return the number of recoveries.
+        inline uint16_t getRecoveryCount(ErrorCause errorCause) const noexcept
+        {
+            return this->recoveryCounts_[static_cast<uint8_t>(errorCause)];
+        }
+
+        /// @brief Gets the statistics of reading the stream from the receiver.
+        /// @return the ingest statistics.
+        inline const IngestStatistics &getIngestStatistics(void) const noexcept
+        {
+            return this->ingestStatistics_;
+        }
+
         /// @brief Gets the enabling state data.
         /// @return the enabling state data.
         inline const EnablingStateData &getEnablingStateData(void) const noexcept
@@ -163,8 +299,38 @@ namespace lacar::droid_basestation::firmware
         /// @brief Exit of the enabled state.
         void enabledExit(void) noexcept;
 
-        /// @brief Flushes the RTCM buffer.
-        void enabledFlushRTCMBuffer(void) noexcept;
+        /// @brief The static method to deliver a flushed epoch to the sinks.
+        /// @param u the user data (MyGPS class instance).
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        static void staticFlushEpoch(void *u, const uint8_t *epoch, uint16_t epochSize) noexcept;
+
+        /// @brief The static method to check whether a ready epoch may be sent.
+        /// @param u the user data (MyGPS class instance).
+        /// @return true if we're in a correction slot.
+        static bool staticMayFlushEpoch(void *u) noexcept;
+
+        /// @brief Sends the NAV-SVIN poll without waiting for the response.
+        /// @param u the user data (MyGPS class instance).
+        static void staticSendSurveyStatus(void *u) noexcept;
+
+        /// @brief Checks whether the driver stored a NAV-SVIN, and consumes it.
+        /// @param u the user data (MyGPS class instance).
+        /// @return true if a NAV-SVIN was received.
+        static bool staticReceivedSurveyStatus(void *u) noexcept;
+
+        /// @brief Handles the completed NAV-SVIN poll.
+        /// @param u the user data (MyGPS class instance).
+        /// @param received false if the poll timed out.
+        static void staticCompleteSurveyStatus(void *u, bool received) noexcept;
+
+        /// @brief Configures the receiver on the first survey status, and enables the stream
+        ///  once the survey is valid.
+        /// @param received false if the poll timed out.
+        void enablingHandleSurveyStatus(bool received) noexcept;
+
+        /// @brief The command that prints the counters of the sinks and the frame pool.
+        static void staticHandleSinksCommand(void *u, const char *arguments) noexcept;
 
         // Error state.
 
@@ -190,6 +356,14 @@ namespace lacar::droid_basestation::firmware
 
         // Other private method.
 
+        /// @brief Begins the peripheral and the driver settings, the receiver itself is
+        ///  configured from the receiver configuration table.
+        /// @return the cause of the failure, or Ok.
+        ErrorCause beginPeripheral(void) noexcept;
+
+        /// @brief Prints the ingest statistics to the serial port.
+        void printIngestStatistics(void) noexcept;
+
         /// @brief Transitions to the given state.
         /// @param state The state to transition to.
         void transition(State state) noexcept;
@@ -204,6 +378,16 @@ namespace lacar::droid_basestation::firmware
         /// @param byte The byte to process.
         void processRTCM(uint8_t byte);
 
+        /// @brief Registers a sink of the RTCM epochs, the sinks registered first are served first.
+        /// @param name the name of the sink.
+        /// @param writeCallback the callback that writes an epoch to the sink.
+        /// @param capacityCallback the callback that reports the capacity, or null if the sink
+        ///  accepts everything.
+        /// @param userData the user data passed to the callbacks.
+        /// @return false if there is no room for another sink.
+        bool addSink(const char *name, RTCMFanout::WriteCallback writeCallback,
+                     RTCMFanout::CapacityCallback capacityCallback, void *userData) noexcept;
+
         /// @brief Enables the GPS.
         void enable(void) noexcept;
 
@@ -0,0 +1,175 @@
+#include "MyLogger.hpp"
+#include "MyConsole.hpp"
+#include "MyGPS.hpp"
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__ENABLED
+
+namespace lacar::droid_basestation::firmware
+{
+    MyLogger MyLogger::s_Instance;
+
+    /// @brief The command that prints the statistics.
+    void MyLogger::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+        static_cast<MyLogger *>(u)->printStatistics();
+    }
+
+    /// @brief The sink that appends the flushed epochs to the log, which copies them into
+    ///  its blocks to frame the records.
+    bool MyLogger::staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept
+    {
+        (void)frame;
+        return static_cast<MyLogger *>(u)->append(epoch, epochSize);
+    }
+
+    /// @brief The capacity of the log sink, the free space of the write-behind blocks.
+    uint16_t MyLogger::staticEpochCapacity(void *u) noexcept
+    {
+        const uint32_t freeSize = static_cast<MyLogger *>(u)->writer_.getFreeSize();
+        return freeSize < UINT16_MAX ? static_cast<uint16_t>(freeSize) : UINT16_MAX;
+    }
+
+    /// @brief Constructs a new logger instance.
+    MyLogger::MyLogger(void) noexcept
+        : storage_(LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SD_CS),
+          blocks_(),
+          writer_(storage_, blocks_, LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__BLOCK_COUNT,
+                  LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__MAX_FILE_SIZE),
+          backoff_(LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__INITIAL_DELAY,
+                   LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_DELAY,
+                   LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_ATTEMPTS),
+          lastAppendMillis_(0U),
+          maxWriteMicros_(0U),
+          synced_(true)
+    {
+    }
+
+    /// @brief Starts the writer, and schedules the next attempt if it fails.
+    void MyLogger::begin(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        if (this->writer_.begin(currentMillis))
+        {
+            Serial.print(F("Logging RTCM to file "));
+            Serial.println(this->writer_.getFileIndex());
+
+            this->backoff_.reset();
+            return;
+        }
+
+        Serial.println(F("Failed to start the RTCM log"));
+
+        this->backoff_.start(currentMillis);
+    }
+
+    /// @brief Appends the frames of the given epoch to the log, never blocks.
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @return false if any of the frames was dropped.
+    bool MyLogger::append(const uint8_t *epoch, uint16_t epochSize) noexcept
+    {
+        this->lastAppendMillis_ = millis();
+        this->synced_ = false;
+
+        return this->writer_.appendFrames(this->lastAppendMillis_, epoch, epochSize) == 0U;
+    }
+
+    /// @brief Prints the statistics to the serial port.
+    void MyLogger::printStatistics(void) noexcept
+    {
+        const RTCMLogWriter::Statistics &statistics = this->writer_.getStatistics();
+
+        Serial.print(F("LOG open="));
+        Serial.print(this->writer_.isOpen());
+        Serial.print(F(" file="));
+        Serial.print(this->writer_.getFileIndex());
+        Serial.print(F(" records="));
+        Serial.print(statistics.records);
+        Serial.print(F(" dropped="));
+        Serial.print(statistics.droppedRecords);
+        Serial.print(F(" blocks="));
+        Serial.print(statistics.blocksWritten);
+        Serial.print(F(" errors="));
+        Serial.print(statistics.writeErrors);
+        Serial.print(F(" rotations="));
+        Serial.print(statistics.rotations);
+        Serial.print(F(" max_write="));
+        Serial.print(this->maxWriteMicros_);
+        Serial.println(F("us"));
+    }
+
+    /// @brief Performs the setup of the logger.
+    void MyLogger::setup(void) noexcept
+    {
+        // Keeps the card deselected while the radio uses the bus.
+        pinMode(LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SD_CS, OUTPUT);
+        digitalWrite(LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SD_CS, HIGH);
+
+        this->begin();
+
+        MyGPS::getInstance().addSink("log", MyLogger::staticWriteEpoch, MyLogger::staticEpochCapacity, this);
+
+        MyConsole::getInstance().registerCommand(F("log"), F("prints the RTCM log statistics"),
+                                                 MyLogger::staticHandleCommand, this);
+    }
+
+    /// @brief Writes the pending blocks while the radio path is idle.
+    void MyLogger::loop(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Retries to start the log, the card may have been inserted later on.
+        if (!this->writer_.isOpen())
+        {
+            if (this->backoff_.isDue(currentMillis))
+            {
+                this->backoff_.next();
+                this->begin();
+            }
+
+            return;
+        }
+
+        // Only touches the card when no epoch is being received or held for its slot.
+        if (!MyGPS::getInstance().isEpochBufferEmpty())
+            return;
+
+        // Pads the last block once the stream goes quiet, so it reaches the card.
+        if (!this->synced_ && !this->writer_.hasPendingBlocks() && this->writer_.hasPartialBlock() &&
+            currentMillis - this->lastAppendMillis_ > LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SYNC_AFTER)
+            this->writer_.pad();
+
+        if (this->writer_.hasPendingBlocks())
+        {
+            // Writes a single block per loop, and keeps track of the latency of the card.
+            const uint32_t startMicros = micros();
+            const bool written = this->writer_.service(currentMillis);
+            const uint32_t writeMicros = micros() - startMicros;
+
+            if (writeMicros > this->maxWriteMicros_)
+                this->maxWriteMicros_ = writeMicros;
+
+            // Restarts the log on the next file once the card is back.
+            if (!written)
+            {
+                Serial.println(F("RTCM log write failed"));
+
+                this->writer_.end();
+                this->backoff_.start(currentMillis);
+            }
+
+            return;
+        }
+
+        // Commits the file size once everything has been written.
+        if (!this->synced_ && !this->writer_.hasPartialBlock())
+        {
+            this->storage_.sync();
+            this->synced_ = true;
+        }
+    }
+}
+
+#endif
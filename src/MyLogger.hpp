@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Backoff.hpp"
+#include "RTCMLogWriter.hpp"
+#include "SDLogStorage.hpp"
+#include "RTCMFramePool.hpp"
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Logs the RTCM stream to the SD card for post-processing.
+    ///
+    /// The epochs are appended to the write-behind blocks of the writer when they're sent,
+    ///  and the blocks are only written while no epoch is being received or waiting to be
+    ///  sent, so the latency of the card does not delay the corrections.
+    class MyLogger
+    {
+    private:
+        static MyLogger s_Instance;
+
+    public:
+        /// @brief Gets the current logger instance.
+        /// @return The logger instance.
+        static inline MyLogger &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+    private:
+        /// @brief The command that prints the statistics.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+        /// @brief The sink that appends the flushed epochs to the log, which copies them into
+        ///  its blocks to frame the records.
+        static bool staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept;
+
+        /// @brief The capacity of the log sink, the free space of the write-behind blocks.
+        static uint16_t staticEpochCapacity(void *u) noexcept;
+
+    private:
+        SDLogStorage storage_;
+        uint8_t blocks_[LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__BLOCK_COUNT * RTCMLogWriter::BlockSize];
+        RTCMLogWriter writer_;
+        Backoff backoff_;
+        uint32_t lastAppendMillis_;
+        uint32_t maxWriteMicros_;
+        bool synced_;
+
+    public:
+        /// @brief Constructs a new logger instance.
+        MyLogger(void) noexcept;
+
+    private:
+        /// @brief Starts the writer, and schedules the next attempt if it fails.
+        void begin(void) noexcept;
+
+    public:
+        /// @brief Gets the writer, which holds the statistics.
+        /// @return the writer.
+        inline const RTCMLogWriter &getWriter(void) const noexcept
+        {
+            return this->writer_;
+        }
+
+        /// @brief Appends the frames of the given epoch to the log, never blocks.
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @return false if any of the frames was dropped.
+        bool append(const uint8_t *epoch, uint16_t epochSize) noexcept;
+
+        /// @brief Prints the statistics to the serial port.
+        void printStatistics(void) noexcept;
+
+        /// @brief Performs the setup of the logger.
+        void setup(void) noexcept;
+
+        /// @brief Writes the pending blocks while the radio path is idle.
+        void loop(void) noexcept;
+    };
+}
@@ -0,0 +1,184 @@
+#include "MyMemory.hpp"
+#include "MyCom.hpp"
+#include "MyGPS.hpp"
+#include "MyDisplay.hpp"
+#include "MyEvents.hpp"
+#include "MyConsole.hpp"
+#include "MyProfiler.hpp"
+#include "MySchedule.hpp"
+#include "MyWatchdog.hpp"
+#include "MyLogger.hpp"
+#include "MySerialOutput.hpp"
+
+#if defined(__AVR__)
+
+extern uint8_t __data_start;
+extern uint8_t __heap_start;
+extern uint8_t _end;
+extern uint8_t __stack;
+extern char *__brkval;
+
+/// @brief Paints the RAM between the end of the static data and the top of the stack
+///  with the canary. Runs in .init3, after .init2 has cleared the zero register and set
+///  up the stack pointer (which the compiled code relies on), but before anything is on
+///  the stack and before .init4 fills the static data it does not touch.
+extern "C" void lacarDroidBasestationFirmwarePaintStack(void) __attribute__((naked, used, section(".init3")));
+
+extern "C" void lacarDroidBasestationFirmwarePaintStack(void)
+{
+    uint8_t *p = &_end;
+
+    while (p <= &__stack)
+        *p++ = LACAR_DROID_BASESTATION_FIRMWARE__MEMORY__CANARY;
+}
+
+#endif
+
+namespace lacar::droid_basestation::firmware
+{
+    MyMemory MyMemory::s_Instance;
+
+    /// @brief The command that prints the RAM usage.
+    void MyMemory::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+
+        MyMemory &memory = *static_cast<MyMemory *>(u);
+        memory.printModules();
+        memory.printUsage();
+    }
+
+    /// @brief Constructs a new memory instance.
+    MyMemory::MyMemory(void) noexcept
+        : lastScanMillis_(0U),
+          minFreeSize_(UINT16_MAX)
+    {
+    }
+
+    /// @brief Scans the painted region for the lowest free space since boot.
+    /// @return the number of untouched bytes between the heap and the stack.
+    uint16_t MyMemory::scan(void) noexcept
+    {
+#if defined(__AVR__)
+        // Starts at the end of the heap, or at the end of the static data if
+        //  nothing has been allocated yet.
+        const uint8_t *p = __brkval != nullptr ? reinterpret_cast<const uint8_t *>(__brkval) : &__heap_start;
+        uint16_t untouched = 0U;
+
+        // Counts the bytes that still contain the canary, the first overwritten
+        //  byte is the deepest point the stack has reached.
+        while (p <= &__stack && *p == LACAR_DROID_BASESTATION_FIRMWARE__MEMORY__CANARY)
+        {
+            ++untouched;
+            ++p;
+        }
+
+        // Keeps the lowest value, the heap may grow into the painted region later on.
+        if (untouched < this->minFreeSize_)
+            this->minFreeSize_ = untouched;
+#endif
+
+        return this->minFreeSize_;
+    }
+
+    /// @brief Takes a snapshot of the current RAM usage.
+    /// @param usage the usage to fill.
+    void MyMemory::getUsage(Usage &usage) noexcept
+    {
+#if defined(__AVR__)
+        const uint8_t *heapEnd = __brkval != nullptr ? reinterpret_cast<const uint8_t *>(__brkval) : &__heap_start;
+        const uint8_t *stackPointer = reinterpret_cast<const uint8_t *>(SP);
+
+        usage.staticSize = static_cast<uint16_t>(&__heap_start - &__data_start);
+        usage.heapSize = static_cast<uint16_t>(heapEnd - &__heap_start);
+        usage.stackSize = static_cast<uint16_t>(&__stack - stackPointer);
+        usage.freeSize = static_cast<uint16_t>(stackPointer - heapEnd);
+#else
+        usage.staticSize = 0U;
+        usage.heapSize = 0U;
+        usage.stackSize = 0U;
+        usage.freeSize = 0U;
+#endif
+        usage.minFreeSize = this->scan();
+    }
+
+    /// @brief Prints the current RAM usage to the serial port.
+    void MyMemory::printUsage(void) noexcept
+    {
+        Usage usage;
+        this->getUsage(usage);
+
+        Serial.print(F("RAM static="));
+        Serial.print(usage.staticSize);
+        Serial.print(F(" heap="));
+        Serial.print(usage.heapSize);
+        Serial.print(F(" stack="));
+        Serial.print(usage.stackSize);
+        Serial.print(F(" free="));
+        Serial.print(usage.freeSize);
+        Serial.print(F(" min_free="));
+        Serial.println(usage.minFreeSize);
+    }
+
+    /// @brief Prints the static RAM used by each module to the serial port.
+    void MyMemory::printModules(void) noexcept
+    {
+        Serial.print(F("RAM MyCom="));
+        Serial.print(sizeof(MyCom));
+        Serial.print(F(" MyGPS="));
+        Serial.print(sizeof(MyGPS));
+        Serial.print(F(" MyDisplay="));
+        Serial.print(sizeof(MyDisplay));
+        Serial.print(F(" MyEvents="));
+        Serial.print(sizeof(MyEvents));
+        Serial.print(F(" MyMemory="));
+        Serial.print(sizeof(MyMemory));
+        Serial.print(F(" MySchedule="));
+        Serial.print(sizeof(MySchedule));
+        Serial.print(F(" MyConsole="));
+        Serial.print(sizeof(MyConsole));
+        Serial.print(F(" MyProfiler="));
+        Serial.print(sizeof(MyProfiler));
+        Serial.print(F(" MyWatchdog="));
+        Serial.print(sizeof(MyWatchdog));
+#if LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__ENABLED
+        Serial.print(F(" MyLogger="));
+        Serial.print(sizeof(MyLogger));
+#endif
+#if LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED
+        Serial.print(F(" MySerialOutput="));
+        Serial.print(sizeof(MySerialOutput));
+#endif
+        Serial.println();
+    }
+
+    /// @brief Performs the setup of the memory instrumentation.
+    void MyMemory::setup(void) noexcept
+    {
+        // Reports the per-module breakdown and the usage after the setup.
+        this->printModules();
+        this->printUsage();
+
+        MyConsole::getInstance().registerCommand(F("mem"), F("prints the RAM usage per module and the high water mark"),
+                                                 MyMemory::staticHandleCommand, this);
+
+        this->lastScanMillis_ = millis();
+    }
+
+    /// @brief Performs the periodic high water mark scan.
+    void MyMemory::loop(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Don't scan if the interval has not elapsed yet.
+        if (currentMillis - this->lastScanMillis_ < LACAR_DROID_BASESTATION_FIRMWARE__MEMORY__SCAN_INTERVAL)
+            return;
+
+        this->lastScanMillis_ = currentMillis;
+
+        // Only reports when the high water mark moved.
+        const uint16_t previousMinFreeSize = this->minFreeSize_;
+        if (this->scan() < previousMinFreeSize)
+            this->printUsage();
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The RAM instrumentation, keeps track of the free space between the heap and the stack.
+    class MyMemory
+    {
+    public:
+        /// @brief A snapshot of the RAM usage.
+        struct Usage
+        {
+        public:
+            uint16_t staticSize;
+            uint16_t heapSize;
+            uint16_t stackSize;
+            uint16_t freeSize;
+            uint16_t minFreeSize;
+        };
+
+    private:
+        static MyMemory s_Instance;
+
+    public:
+        /// @brief Gets the current memory instance.
+        /// @return The memory instance.
+        static inline MyMemory &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+    private:
+        /// @brief The command that prints the RAM usage.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+    private:
+        uint32_t lastScanMillis_;
+        uint16_t minFreeSize_;
+
+    public:
+        /// @brief Constructs a new memory instance.
+        MyMemory(void) noexcept;
+
+    public:
+        /// @brief Gets the lowest amount of untouched RAM between the heap and the stack seen so far.
+        /// @return the high water mark expressed as the remaining free bytes.
+        inline uint16_t getMinFreeSize(void) const noexcept
+        {
+            return this->minFreeSize_;
+        }
+
+        /// @brief Scans the painted region for the lowest free space since boot.
+        /// @return the number of untouched bytes between the heap and the stack.
+        uint16_t scan(void) noexcept;
+
+        /// @brief Takes a snapshot of the current RAM usage.
+        /// @param usage the usage to fill.
+        void getUsage(Usage &usage) noexcept;
+
+        /// @brief Prints the current RAM usage to the serial port.
+        void printUsage(void) noexcept;
+
+        /// @brief Prints the static RAM used by each module to the serial port.
+        void printModules(void) noexcept;
+
+        /// @brief Performs the setup of the memory instrumentation.
+        void setup(void) noexcept;
+
+        /// @brief Performs the periodic high water mark scan.
+        void loop(void) noexcept;
+    };
+}
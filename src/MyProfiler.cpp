@@ -0,0 +1,187 @@
+#include "MyProfiler.hpp"
+#include "MyConsole.hpp"
+
+#if defined(__AVR__) && LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED
+
+ISR(TIMER1_OVF_vect)
+{
+    lacar::droid_basestation::firmware::MyProfiler::handleOverflow();
+}
+
+#endif
+
+namespace lacar::droid_basestation::firmware
+{
+    MyProfiler MyProfiler::s_Instance;
+
+    /// @brief Gets the number of CPU cycles since the setup, wraps around every 2^32 cycles.
+    /// @return the number of cycles.
+    uint32_t MyProfiler::getCycles(void) noexcept
+    {
+#if defined(__AVR__)
+        const uint8_t sreg = SREG;
+        cli();
+
+        const uint16_t low = TCNT1;
+        uint16_t high = s_Instance.overflows_;
+
+        // Accounts for an overflow that happened while the interrupts were disabled, the
+        //  low part has wrapped around already if it is small.
+        if ((TIFR1 & _BV(TOV1)) && low < 0x8000U)
+            ++high;
+
+        SREG = sreg;
+
+        return (static_cast<uint32_t>(high) << 16) | low;
+#elif defined(ARDUINO_ARCH_STM32)
+        return DWT->CYCCNT;
+#else
+        return micros() * (F_CPU / 1000000UL);
+#endif
+    }
+
+    /// @brief Counts an overflow of the timer, called from its interrupt handler.
+    void MyProfiler::handleOverflow(void) noexcept
+    {
+        ++s_Instance.overflows_;
+    }
+
+    /// @brief Gets the name of the given zone.
+    /// @param zone the zone.
+    /// @return the name, stored in flash.
+    const __FlashStringHelper *MyProfiler::getZoneName(Zone zone) noexcept
+    {
+        switch (zone)
+        {
+        case Zone::DisplayLoop:
+            return F("display_loop");
+        case Zone::ComLoop:
+            return F("com_loop");
+        case Zone::GPSLoop:
+            return F("gps_loop");
+        case Zone::GPSCheckUblox:
+            return F("gps_check_ublox");
+        case Zone::ComMulticast:
+            return F("com_multicast");
+        case Zone::ComAuthenticate:
+            return F("com_authenticate");
+        default:
+            return F("unknown");
+        }
+    }
+
+    /// @brief The command that prints or resets the statistics.
+    void MyProfiler::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        MyProfiler &profiler = *static_cast<MyProfiler *>(u);
+
+        if (strcmp_P(arguments, PSTR("reset")) == 0)
+            profiler.reset();
+        else
+            profiler.printStatistics();
+    }
+
+    /// @brief Constructs a new profiler instance.
+    MyProfiler::MyProfiler(void) noexcept
+        : zones_(),
+          overflows_(0U),
+          overheadCycles_(0U)
+    {
+        this->reset();
+    }
+
+    /// @brief Records a single measurement of the given zone.
+    /// @param zone the zone.
+    /// @param cycles the measured cycles, including the overhead of the measurement.
+    void MyProfiler::record(Zone zone, uint32_t cycles) noexcept
+    {
+        ZoneStatistics &statistics = this->zones_[static_cast<uint8_t>(zone)];
+
+        // Removes the time it takes to read the timer twice.
+        cycles = cycles > this->overheadCycles_ ? cycles - this->overheadCycles_ : 0U;
+
+        ++statistics.count;
+        statistics.totalCycles += cycles;
+
+        if (cycles < statistics.minCycles)
+            statistics.minCycles = cycles;
+        if (cycles > statistics.maxCycles)
+            statistics.maxCycles = cycles;
+    }
+
+    /// @brief Clears the statistics of all zones.
+    void MyProfiler::reset(void) noexcept
+    {
+        for (ZoneStatistics &statistics : this->zones_)
+        {
+            statistics.count = 0U;
+            statistics.minCycles = UINT32_MAX;
+            statistics.maxCycles = 0U;
+            statistics.totalCycles = 0U;
+        }
+    }
+
+    /// @brief Prints the statistics of all zones to the serial port.
+    void MyProfiler::printStatistics(void) noexcept
+    {
+        for (uint8_t i = 0U; i < ZoneCount; ++i)
+        {
+            const ZoneStatistics &statistics = this->zones_[i];
+
+            Serial.print(F("PROF "));
+            Serial.print(getZoneName(static_cast<Zone>(i)));
+            Serial.print(F(" count="));
+            Serial.print(statistics.count);
+
+            if (statistics.count == 0U)
+            {
+                Serial.println();
+                continue;
+            }
+
+            // Prints the cycles, and the microseconds they correspond with.
+            const uint32_t meanCycles = static_cast<uint32_t>(statistics.totalCycles / statistics.count);
+
+            Serial.print(F(" min="));
+            Serial.print(statistics.minCycles);
+            Serial.print(F(" mean="));
+            Serial.print(meanCycles);
+            Serial.print(F(" max="));
+            Serial.print(statistics.maxCycles);
+            Serial.print(F(" cycles ("));
+            Serial.print(statistics.minCycles / (F_CPU / 1000000UL));
+            Serial.print(F("/"));
+            Serial.print(meanCycles / (F_CPU / 1000000UL));
+            Serial.print(F("/"));
+            Serial.print(statistics.maxCycles / (F_CPU / 1000000UL));
+            Serial.println(F(" us)"));
+        }
+    }
+
+    /// @brief Starts the timer, measures the overhead of a measurement and registers the command.
+    void MyProfiler::setup(void) noexcept
+    {
+#if defined(__AVR__) && LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED
+        // Runs Timer1 in normal mode without a prescaler, it overflows every 65536 cycles.
+        TCCR1A = 0U;
+        TCCR1B = _BV(CS10);
+        TCNT1 = 0U;
+        TIFR1 = _BV(TOV1);
+        TIMSK1 = _BV(TOIE1);
+#elif defined(ARDUINO_ARCH_STM32) && LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED
+        // Starts the cycle counter of the Cortex-M debug unit, it needs no interrupt.
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED && (defined(__AVR__) || defined(ARDUINO_ARCH_STM32))
+        // Measures an empty zone, which is subtracted from every measurement.
+        const uint32_t startCycles = getCycles();
+        this->overheadCycles_ = static_cast<uint8_t>(getCycles() - startCycles);
+#endif
+
+        MyConsole::getInstance().registerCommand(F("prof"), F("prints the zone timings, 'prof reset' clears them"),
+                                                 MyProfiler::staticHandleCommand, this);
+    }
+}
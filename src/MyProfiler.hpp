@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The cycle accurate profiler, measures the time spent in zones of the firmware with
+    ///  a free running counter at the CPU clock (Timer1 on AVR, the DWT cycle counter on STM32),
+    ///  so it includes the time waiting for SPI and I2C.
+    class MyProfiler
+    {
+    public:
+        /// @brief The profiled zones, outer zones include the time of the inner ones.
+        enum class Zone : uint8_t
+        {
+            DisplayLoop = 0,
+            ComLoop = 1,
+            GPSLoop = 2,
+            GPSCheckUblox = 3,
+            ComMulticast = 4,
+            ComAuthenticate = 5,
+        };
+
+        /// @brief The number of zones.
+        static constexpr uint8_t ZoneCount = 6U;
+
+        /// @brief The aggregated measurements of a single zone.
+        struct ZoneStatistics
+        {
+        public:
+            uint32_t count;
+            uint32_t minCycles;
+            uint32_t maxCycles;
+            uint64_t totalCycles;
+        };
+
+        /// @brief Measures the zone from its construction until it goes out of scope.
+        class Scope
+        {
+        private:
+            const uint32_t startCycles_;
+            const Zone zone_;
+
+        public:
+            inline Scope(Zone zone) noexcept
+                : startCycles_(MyProfiler::getCycles()),
+                  zone_(zone)
+            {
+            }
+
+            inline ~Scope(void) noexcept
+            {
+                MyProfiler::getInstance().record(this->zone_, MyProfiler::getCycles() - this->startCycles_);
+            }
+        };
+
+    private:
+        static MyProfiler s_Instance;
+
+    public:
+        /// @brief Gets the current profiler instance.
+        /// @return The profiler instance.
+        static inline MyProfiler &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+        /// @brief Gets the number of CPU cycles since the setup, wraps around every 2^32 cycles.
+        /// @return the number of cycles.
+        static uint32_t getCycles(void) noexcept;
+
+        /// @brief Counts an overflow of the timer, called from its interrupt handler.
+        static void handleOverflow(void) noexcept;
+
+        /// @brief Gets the name of the given zone.
+        /// @param zone the zone.
+        /// @return the name, stored in flash.
+        static const __FlashStringHelper *getZoneName(Zone zone) noexcept;
+
+    private:
+        /// @brief The command that prints or resets the statistics.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+    private:
+        ZoneStatistics zones_[ZoneCount];
+        volatile uint16_t overflows_;
+        uint8_t overheadCycles_;
+
+    public:
+        /// @brief Constructs a new profiler instance.
+        MyProfiler(void) noexcept;
+
+    public:
+        /// @brief Gets the statistics of the given zone.
+        /// @param zone the zone.
+        /// @return the statistics.
+        inline const ZoneStatistics &getZoneStatistics(Zone zone) const noexcept
+        {
+            return this->zones_[static_cast<uint8_t>(zone)];
+        }
+
+        /// @brief Records a single measurement of the given zone.
+        /// @param zone the zone.
+        /// @param cycles the measured cycles, including the overhead of the measurement.
+        void record(Zone zone, uint32_t cycles) noexcept;
+
+        /// @brief Clears the statistics of all zones.
+        void reset(void) noexcept;
+
+        /// @brief Prints the statistics of all zones to the serial port.
+        void printStatistics(void) noexcept;
+
+        /// @brief Starts the timer, measures the overhead of a measurement and registers the command.
+        void setup(void) noexcept;
+    };
+}
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED
+/// @brief Profiles the rest of the enclosing scope as the given zone.
+#define LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(zone) \
+    ::lacar::droid_basestation::firmware::MyProfiler::Scope profilerScope(::lacar::droid_basestation::firmware::MyProfiler::Zone::zone)
+#else
+#define LACAR_DROID_BASESTATION_FIRMWARE__PROFILE_ZONE(zone)
+#endif
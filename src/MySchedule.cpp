@@ -0,0 +1,224 @@
+#include "MySchedule.hpp"
+#include "MyConsole.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    MySchedule MySchedule::s_Instance;
+
+    /// @brief The interrupt handler of the PPS edge.
+    void MySchedule::staticHandlePPS(void) noexcept
+    {
+        s_Instance.ppsMicros_ = micros();
+        ++s_Instance.ppsEdges_;
+    }
+
+    /// @brief The command that prints the slot statistics.
+    void MySchedule::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        (void)arguments;
+        static_cast<MySchedule *>(u)->printStatistics();
+    }
+
+    /// @brief Constructs a new schedule instance.
+    MySchedule::MySchedule(void) noexcept
+        : ppsMicros_(0U),
+          ppsEdges_(0U),
+          statistics_(),
+          foreignStations_(),
+          correctionSlots_(static_cast<uint16_t>(InitialCorrectionSlots)),
+          lastUsedFrame_(0U),
+          lastUsedSlot_(UINT8_MAX)
+    {
+    }
+
+    /// @brief Gets the position in the schedule at the given time.
+    /// @param currentMicros the current time.
+    /// @param position the position to fill.
+    void MySchedule::getPosition(uint32_t currentMicros, Position &position) noexcept
+    {
+        // Copies the values of the interrupt handler atomically.
+        noInterrupts();
+        const uint32_t ppsMicros = this->ppsMicros_;
+        const uint32_t ppsEdges = this->ppsEdges_;
+        interrupts();
+
+        this->statistics_.ppsEdges = ppsEdges;
+
+        // Keeps counting frames from the last edge when a PPS is missed, until the
+        //  timeout has elapsed.
+        const uint32_t sincePPS = currentMicros - ppsMicros;
+        const uint32_t framesSincePPS = sincePPS / 1000000UL;
+        const uint32_t inFrame = sincePPS % 1000000UL;
+
+        position.synchronized = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__ENABLED && ppsEdges > 0U &&
+                                sincePPS < LACAR_DROID_BASESTATION_FIRMWARE__TDMA__PPS_TIMEOUT;
+        position.frame = ppsEdges + framesSincePPS;
+        position.slot = static_cast<uint8_t>(min(inFrame / LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_LENGTH,
+                                                 static_cast<uint32_t>(LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT - 1U)));
+        position.remainingMicros = (position.slot + 1U) * LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_LENGTH - inFrame;
+    }
+
+    /// @brief Checks whether the corrections may be sent right now.
+    /// @return true if we're in a correction slot, or not synchronized.
+    bool MySchedule::isCorrectionSlot(void) noexcept
+    {
+        Position position;
+        this->getPosition(micros(), position);
+
+        return !position.synchronized || this->isCorrectionSlot(position.slot);
+    }
+
+    /// @brief Fills the announcement of the schedule.
+    /// @param announcement the announcement to fill.
+    void MySchedule::getAnnouncement(protocol::ScheduleAnnouncement &announcement) const noexcept
+    {
+        announcement.station = LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID;
+        announcement.slotLength = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_LENGTH;
+        announcement.correctionSlots = this->correctionSlots_;
+        announcement.uplinkSlots = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__UPLINK_SLOTS;
+        announcement.slotCount = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT;
+    }
+
+    /// @brief Handles the announcement of another base station, moving our correction
+    ///  slots if they overlap with those of a station with a lower ID.
+    /// @param announcement the announcement.
+    void MySchedule::handleAnnouncement(const protocol::ScheduleAnnouncement &announcement) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        // Another base station with our ID, nothing we can do but report it.
+        if (announcement.station == LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID)
+        {
+            ++this->statistics_.stationConflicts;
+            return;
+        }
+
+        // Remembers the slots of the station, replacing the least recently heard one.
+        ForeignStation *slot = &this->foreignStations_[0];
+        for (uint8_t i = 0U; i < LACAR_DROID_BASESTATION_FIRMWARE__TDMA__MAX_FOREIGN_STATIONS; ++i)
+        {
+            ForeignStation &foreign = this->foreignStations_[i];
+
+            if (foreign.used && foreign.station == announcement.station)
+            {
+                slot = &foreign;
+                break;
+            }
+
+            if (!foreign.used || (slot->used && currentMillis - foreign.lastHeardMillis > currentMillis - slot->lastHeardMillis))
+                slot = &foreign;
+        }
+
+        slot->used = true;
+        slot->station = announcement.station;
+        slot->correctionSlots = announcement.correctionSlots;
+        slot->lastHeardMillis = currentMillis;
+
+        // The station with the lower ID keeps its slots.
+        if (announcement.station > LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID ||
+            (announcement.correctionSlots & this->correctionSlots_) == 0U)
+            return;
+
+        // Collects the slots taken by the stations we've heard recently, and the uplink.
+        uint16_t taken = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__UPLINK_SLOTS;
+        for (uint8_t i = 0U; i < LACAR_DROID_BASESTATION_FIRMWARE__TDMA__MAX_FOREIGN_STATIONS; ++i)
+        {
+            const ForeignStation &foreign = this->foreignStations_[i];
+
+            if (foreign.used && currentMillis - foreign.lastHeardMillis < LACAR_DROID_BASESTATION_FIRMWARE__TDMA__FOREIGN_STATION_TIMEOUT)
+                taken |= foreign.correctionSlots;
+        }
+
+        // Moves our slots to the first free position, keeping their pattern.
+        const uint16_t pattern = LACAR_DROID_BASESTATION_FIRMWARE__TDMA__CORRECTION_SLOTS;
+        const uint16_t frameMask = static_cast<uint16_t>((1UL << LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT) - 1U);
+
+        for (uint8_t shift = 0U; shift < LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT; ++shift)
+        {
+            const uint16_t candidate = static_cast<uint16_t>(pattern << shift);
+
+            if ((candidate & ~frameMask) != 0U)
+                break;
+
+            if ((candidate & taken) == 0U)
+            {
+                this->correctionSlots_ = candidate;
+                ++this->statistics_.reallocations;
+                return;
+            }
+        }
+
+        // No free slots, keep sending in ours and count the conflict.
+        ++this->statistics_.stationConflicts;
+    }
+
+    /// @brief Records a transmission for the occupancy and overrun statistics.
+    /// @param startMicros the start of the transmission.
+    /// @param endMicros the end of the transmission.
+    void MySchedule::recordTransmission(uint32_t startMicros, uint32_t endMicros) noexcept
+    {
+        Position position;
+        this->getPosition(startMicros, position);
+
+        // Nothing to record without a schedule.
+        if (!position.synchronized)
+            return;
+
+        // Counts the transmissions that started outside of a correction slot.
+        if (!this->isCorrectionSlot(position.slot))
+        {
+            ++this->statistics_.outOfSlot;
+            return;
+        }
+
+        // Counts every slot once for the occupancy.
+        if (position.frame != this->lastUsedFrame_ || position.slot != this->lastUsedSlot_)
+        {
+            ++this->statistics_.slotsUsed;
+            this->lastUsedFrame_ = position.frame;
+            this->lastUsedSlot_ = position.slot;
+        }
+
+        const uint32_t duration = endMicros - startMicros;
+        this->statistics_.busyMicros += duration;
+
+        // Counts the transmissions that ran past the end of their slot.
+        if (duration > position.remainingMicros)
+            ++this->statistics_.overruns;
+    }
+
+    /// @brief Prints the slot statistics to the serial port.
+    void MySchedule::printStatistics(void) noexcept
+    {
+        const uint32_t capacity = this->statistics_.slotsUsed * (LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_LENGTH / 100UL);
+
+        Serial.print(F("TDMA pps="));
+        Serial.print(this->statistics_.ppsEdges);
+        Serial.print(F(" slots="));
+        Serial.print(this->statistics_.slotsUsed);
+        Serial.print(F(" occupancy="));
+        Serial.print(capacity > 0U ? this->statistics_.busyMicros / capacity : 0U);
+        Serial.print(F("% overruns="));
+        Serial.print(this->statistics_.overruns);
+        Serial.print(F(" out_of_slot="));
+        Serial.print(this->statistics_.outOfSlot);
+        Serial.print(F(" reallocations="));
+        Serial.print(this->statistics_.reallocations);
+        Serial.print(F(" conflicts="));
+        Serial.println(this->statistics_.stationConflicts);
+    }
+
+    /// @brief Performs the setup of the schedule.
+    void MySchedule::setup(void) noexcept
+    {
+#if LACAR_DROID_BASESTATION_FIRMWARE__TDMA__ENABLED
+        // Captures the rising edge of the TIMEPULSE of the receiver.
+        pinMode(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TIMEPULSE_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(LACAR_DROID_BASESTATION_FIRMWARE__GPS__TIMEPULSE_PIN),
+                        MySchedule::staticHandlePPS, RISING);
+#endif
+
+        MyConsole::getInstance().registerCommand(F("tdma"), F("prints the slot statistics"),
+                                                 MySchedule::staticHandleCommand, this);
+    }
+}
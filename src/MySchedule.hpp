@@ -0,0 +1,161 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+#include <DroidProtocol.hpp>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The TDMA schedule of the radio, disciplined by the PPS (TIMEPULSE) of the receiver.
+    ///
+    /// Every second starts a frame at the PPS edge, divided in slots of equal length. The
+    ///  corrections are only sent in the correction slots, and the rovers only talk back in
+    ///  the uplink slots. Without PPS every slot is a correction slot.
+    ///
+    /// Base stations sharing the channel start with correction slots offset by their station
+    ///  ID, and the one with the higher ID moves its slots when they overlap with another.
+    class MySchedule
+    {
+    public:
+        /// @brief The slot statistics.
+        struct Statistics
+        {
+        public:
+            uint32_t ppsEdges;
+            uint32_t slotsUsed;
+            uint32_t busyMicros;
+            uint32_t overruns;
+            uint32_t outOfSlot;
+            uint32_t reallocations;
+            uint32_t stationConflicts;
+        };
+
+        /// @brief Another base station sharing the channel.
+        struct ForeignStation
+        {
+        public:
+            uint32_t lastHeardMillis;
+            uint16_t correctionSlots;
+            uint8_t station;
+            bool used;
+        };
+
+        /// @brief The position in the schedule at a given time.
+        struct Position
+        {
+        public:
+            uint32_t frame;
+            uint32_t remainingMicros;
+            uint8_t slot;
+            bool synchronized;
+        };
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT <= 16,
+                      "The slots of a frame must fit in the 16-bit slot masks");
+
+        static_assert(LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID * LACAR_DROID_BASESTATION_FIRMWARE__TDMA__STATION_SLOT_STRIDE <
+                          LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT,
+                      "The correction slots of the station must start within the frame");
+
+        /// @brief The correction slots we start with, offset by the station ID.
+        static constexpr uint32_t InitialCorrectionSlots =
+            static_cast<uint32_t>(LACAR_DROID_BASESTATION_FIRMWARE__TDMA__CORRECTION_SLOTS)
+            << (LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID * LACAR_DROID_BASESTATION_FIRMWARE__TDMA__STATION_SLOT_STRIDE);
+
+        static_assert((InitialCorrectionSlots & ~((1UL << LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT) - 1U)) == 0U,
+                      "The correction slots of the station must end within the frame, use a lower station ID or stride");
+        static_assert((InitialCorrectionSlots & LACAR_DROID_BASESTATION_FIRMWARE__TDMA__UPLINK_SLOTS) == 0U,
+                      "The correction slots of the station must not overlap the uplink slots, use a lower station ID or stride");
+
+    private:
+        static MySchedule s_Instance;
+
+    public:
+        /// @brief Gets the current schedule instance.
+        /// @return The schedule instance.
+        static inline MySchedule &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+    private:
+        /// @brief The interrupt handler of the PPS edge.
+        static void staticHandlePPS(void) noexcept;
+
+        /// @brief The command that prints the slot statistics.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+    private:
+        volatile uint32_t ppsMicros_;
+        volatile uint32_t ppsEdges_;
+        Statistics statistics_;
+        ForeignStation foreignStations_[LACAR_DROID_BASESTATION_FIRMWARE__TDMA__MAX_FOREIGN_STATIONS];
+        uint16_t correctionSlots_;
+        uint32_t lastUsedFrame_;
+        uint8_t lastUsedSlot_;
+
+    public:
+        /// @brief Constructs a new schedule instance.
+        MySchedule(void) noexcept;
+
+    public:
+        /// @brief Gets the slot statistics.
+        /// @return the statistics.
+        inline const Statistics &getStatistics(void) const noexcept
+        {
+            return this->statistics_;
+        }
+
+        /// @brief Gets the correction slots of this station.
+        /// @return the mask of correction slots.
+        inline uint16_t getCorrectionSlots(void) const noexcept
+        {
+            return this->correctionSlots_;
+        }
+
+        /// @brief Checks whether the given slot is a correction slot of this station.
+        /// @param slot the slot.
+        /// @return true if it's a correction slot.
+        inline bool isCorrectionSlot(uint8_t slot) const noexcept
+        {
+            return (this->correctionSlots_ & static_cast<uint16_t>(1U << slot)) != 0U;
+        }
+
+        /// @brief Checks whether the given slot is an uplink slot of the rovers.
+        /// @param slot the slot.
+        /// @return true if it's an uplink slot.
+        inline bool isUplinkSlot(uint8_t slot) const noexcept
+        {
+            return (LACAR_DROID_BASESTATION_FIRMWARE__TDMA__UPLINK_SLOTS & static_cast<uint16_t>(1U << slot)) != 0U;
+        }
+
+        /// @brief Gets the position in the schedule at the given time.
+        /// @param currentMicros the current time.
+        /// @param position the position to fill.
+        void getPosition(uint32_t currentMicros, Position &position) noexcept;
+
+        /// @brief Checks whether the corrections may be sent right now.
+        /// @return true if we're in a correction slot, or not synchronized.
+        bool isCorrectionSlot(void) noexcept;
+
+        /// @brief Fills the announcement of the schedule.
+        /// @param announcement the announcement to fill.
+        void getAnnouncement(protocol::ScheduleAnnouncement &announcement) const noexcept;
+
+        /// @brief Handles the announcement of another base station, moving our correction
+        ///  slots if they overlap with those of a station with a lower ID.
+        /// @param announcement the announcement.
+        void handleAnnouncement(const protocol::ScheduleAnnouncement &announcement) noexcept;
+
+        /// @brief Records a transmission for the occupancy and overrun statistics.
+        /// @param startMicros the start of the transmission.
+        /// @param endMicros the end of the transmission.
+        void recordTransmission(uint32_t startMicros, uint32_t endMicros) noexcept;
+
+        /// @brief Prints the slot statistics to the serial port.
+        void printStatistics(void) noexcept;
+
+        /// @brief Performs the setup of the schedule.
+        void setup(void) noexcept;
+    };
+}
@@ -0,0 +1,102 @@
+#include "MySerialOutput.hpp"
+#include "MyGPS.hpp"
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED
+
+namespace lacar::droid_basestation::firmware
+{
+    MySerialOutput MySerialOutput::s_Instance;
+
+    /// @brief The sink that queues the flushed epochs.
+    /// @param u the user data (MySerialOutput class instance).
+    /// @param epoch the frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param frame the frame holding the epoch in the pool.
+    /// @return false if the epoch is not in the pool.
+    bool MySerialOutput::staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept
+    {
+        (void)epoch;
+        (void)epochSize;
+
+        return static_cast<MySerialOutput *>(u)->write(frame);
+    }
+
+    /// @brief The capacity of the serial sink, nothing while the queue is full.
+    /// @param u the user data (MySerialOutput class instance).
+    /// @return the number of bytes the sink accepts.
+    uint16_t MySerialOutput::staticEpochCapacity(void *u) noexcept
+    {
+        return static_cast<MySerialOutput *>(u)->size_ < LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE ? UINT16_MAX : 0U;
+    }
+
+    /// @brief Constructs a new serial output instance.
+    MySerialOutput::MySerialOutput(void) noexcept
+        : queue_(),
+          offset_(0U),
+          tail_(0U),
+          size_(0U)
+    {
+    }
+
+    /// @brief Queues the given frame, never blocks.
+    /// @param frame the frame in the pool.
+    /// @return false if the queue is full or there is no frame.
+    bool MySerialOutput::write(RTCMFramePool::Handle frame) noexcept
+    {
+        if (frame == RTCMFramePool::NoBlock || this->size_ >= LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE)
+            return false;
+
+        // Holds the frame until it has been written, instead of copying it.
+        MyGPS::getInstance().getFramePool().retain(frame);
+
+        this->queue_[(this->tail_ + this->size_) % LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE] = frame;
+        ++this->size_;
+
+        return true;
+    }
+
+    /// @brief Performs the setup of the serial output.
+    void MySerialOutput::setup(void) noexcept
+    {
+        LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__PORT.begin(LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__BAUD_RATE);
+
+        MyGPS::getInstance().addSink("serial", MySerialOutput::staticWriteEpoch, MySerialOutput::staticEpochCapacity, this);
+    }
+
+    /// @brief Moves the queued bytes to the transmit buffer of the port.
+    void MySerialOutput::loop(void) noexcept
+    {
+        HardwareSerial &port = LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__PORT;
+        RTCMFramePool &pool = MyGPS::getInstance().getFramePool();
+
+        // Only writes what the transmit buffer takes right now, so the write never waits.
+        uint16_t available = static_cast<uint16_t>(port.availableForWrite());
+
+        while (available > 0U && this->size_ > 0U)
+        {
+            const RTCMFramePool::Handle frame = this->queue_[this->tail_];
+
+            // Writes straight from the blocks of the frame.
+            uint16_t segmentSize;
+            const uint8_t *segment = pool.getSegment(frame, this->offset_, segmentSize);
+            const uint16_t chunkSize = min(available, segmentSize);
+
+            port.write(segment, chunkSize);
+
+            this->offset_ += chunkSize;
+            available -= chunkSize;
+
+            // Lets go of the frame once it has been written completely.
+            if (this->offset_ >= pool.getSize(frame))
+            {
+                pool.release(frame);
+
+                this->tail_ = (this->tail_ + 1U) % LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE;
+                this->offset_ = 0U;
+                --this->size_;
+            }
+        }
+    }
+}
+
+#endif
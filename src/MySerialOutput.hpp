@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+#include "RTCMFramePool.hpp"
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Outputs the RTCM stream on a serial port, for a rover or a radio modem wired
+    ///  directly to the base station.
+    ///
+    /// The flushed epochs are queued by reference to their frame in the pool, and are drained
+    ///  from the loop as far as the transmit buffer of the port allows, so the output never
+    ///  blocks the loop. The transmit buffer of the core is far smaller than an epoch.
+    class MySerialOutput
+    {
+    private:
+        static MySerialOutput s_Instance;
+
+    public:
+        /// @brief Gets the current serial output instance.
+        /// @return The serial output instance.
+        static inline MySerialOutput &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+    private:
+        /// @brief The sink that queues the flushed epochs.
+        /// @param u the user data (MySerialOutput class instance).
+        /// @param epoch the frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param frame the frame holding the epoch in the pool.
+        /// @return false if the epoch is not in the pool.
+        static bool staticWriteEpoch(void *u, const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle frame) noexcept;
+
+        /// @brief The capacity of the serial sink, nothing while the queue is full.
+        /// @param u the user data (MySerialOutput class instance).
+        /// @return the number of bytes the sink accepts.
+        static uint16_t staticEpochCapacity(void *u) noexcept;
+
+    private:
+        RTCMFramePool::Handle queue_[LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE];
+        uint16_t offset_;
+        uint8_t tail_;
+        uint8_t size_;
+
+    public:
+        /// @brief Constructs a new serial output instance.
+        MySerialOutput(void) noexcept;
+
+    public:
+        /// @brief Queues the given frame, never blocks.
+        /// @param frame the frame in the pool.
+        /// @return false if the queue is full or there is no frame.
+        bool write(RTCMFramePool::Handle frame) noexcept;
+
+        /// @brief Performs the setup of the serial output.
+        void setup(void) noexcept;
+
+        /// @brief Moves the queued bytes to the transmit buffer of the port.
+        void loop(void) noexcept;
+    };
+}
@@ -0,0 +1,282 @@
+#include "MyWatchdog.hpp"
+#include "MyConsole.hpp"
+
+#if defined(__AVR__)
+#include <avr/wdt.h>
+
+/// @brief The record that survives a reset, not initialized by the C runtime.
+static lacar::droid_basestation::firmware::MyWatchdog::PersistentRecord g_PersistentRecord
+    __attribute__((section(".noinit")));
+
+/// @brief The reset flags, captured before anything else runs.
+static uint8_t g_ResetFlags __attribute__((section(".noinit")));
+#else
+#if defined(ARDUINO_ARCH_STM32)
+#include <IWatchdog.h>
+#endif
+
+/// @brief The record, the linker scripts of the other cores have no section that survives
+///  a reset, so only the reset itself is reported there.
+static lacar::droid_basestation::firmware::MyWatchdog::PersistentRecord g_PersistentRecord;
+
+/// @brief The reset flags, captured during the setup.
+static uint8_t g_ResetFlags;
+#endif
+
+#if defined(__AVR__)
+
+/// @brief Captures and clears the reset flags, and disables the watchdog, which stays enabled
+///  after a watchdog reset and would otherwise reset the board again during the startup.
+extern "C" void lacarDroidBasestationFirmwareCaptureReset(void) __attribute__((naked, used, section(".init3")));
+
+extern "C" void lacarDroidBasestationFirmwareCaptureReset(void)
+{
+    g_ResetFlags = MCUSR;
+    MCUSR = 0U;
+    wdt_disable();
+}
+
+#endif
+
+namespace lacar::droid_basestation::firmware
+{
+    MyWatchdog MyWatchdog::s_Instance;
+
+    /// @brief Gets the name of the given module.
+    /// @param module the module.
+    /// @return the name, stored in flash.
+    const __FlashStringHelper *MyWatchdog::getModuleName(Module module) noexcept
+    {
+        switch (module)
+        {
+        case Module::None:
+            return F("none");
+        case Module::Setup:
+            return F("setup");
+        case Module::Console:
+            return F("console");
+        case Module::Events:
+            return F("events");
+        case Module::Display:
+            return F("display");
+        case Module::Com:
+            return F("com");
+        case Module::GPS:
+            return F("gps");
+        case Module::Memory:
+            return F("memory");
+        case Module::Logger:
+            return F("logger");
+        case Module::SerialOutput:
+            return F("serial");
+        default:
+            return F("unknown");
+        }
+    }
+
+    /// @brief The command that prints or clears the overruns.
+    void MyWatchdog::staticHandleCommand(void *u, const char *arguments) noexcept
+    {
+        MyWatchdog &watchdog = *static_cast<MyWatchdog *>(u);
+
+        if (strcmp_P(arguments, PSTR("clear")) == 0)
+        {
+            for (ModuleStatistics &statistics : watchdog.modules_)
+                statistics = ModuleStatistics();
+
+            watchdog.maxLoopMicros_ = 0U;
+            g_PersistentRecord.lastOverrun = Overrun();
+            g_PersistentRecord.watchdogResets = 0U;
+            return;
+        }
+
+        watchdog.printStatistics();
+    }
+
+    /// @brief Constructs a new watchdog instance.
+    MyWatchdog::MyWatchdog(void) noexcept
+        : modules_(),
+          enterMicros_(0U),
+          loopMicros_(0U),
+          maxLoopMicros_(0U),
+          resetFlags_(0U),
+          watchdogReset_(false)
+    {
+    }
+
+    /// @brief Records an overrun of the current module.
+    /// @param durationMicros the duration of the call.
+    void MyWatchdog::recordOverrun(uint32_t durationMicros) noexcept
+    {
+        ModuleStatistics &statistics = this->modules_[static_cast<uint8_t>(g_PersistentRecord.currentModule)];
+
+        Overrun &overrun = g_PersistentRecord.lastOverrun;
+        overrun.durationMicros = durationMicros;
+        overrun.module = g_PersistentRecord.currentModule;
+        overrun.state = g_PersistentRecord.currentState;
+
+        ++statistics.overruns;
+
+        // Only reports the worst overrun of every module, the same stall tends to repeat.
+        if (durationMicros <= statistics.worst.durationMicros)
+            return;
+
+        statistics.worst = overrun;
+
+        Serial.print(F("Loop overrun "));
+        printOverrun(overrun);
+    }
+
+    /// @brief Prints the given overrun.
+    /// @param overrun the overrun.
+    void MyWatchdog::printOverrun(const Overrun &overrun) noexcept
+    {
+        Serial.print(getModuleName(overrun.module));
+        Serial.print(F(" state="));
+        Serial.print(overrun.state);
+        Serial.print(F(" duration="));
+        Serial.print(overrun.durationMicros);
+        Serial.println(F("us"));
+    }
+
+    /// @brief Marks the start of a call of the given module.
+    /// @param module the module.
+    /// @param state the state of the module.
+    void MyWatchdog::enter(Module module, uint8_t state) noexcept
+    {
+        g_PersistentRecord.currentModule = module;
+        g_PersistentRecord.currentState = state;
+
+        this->enterMicros_ = micros();
+    }
+
+    /// @brief Marks the end of the current call, and records it if it overran the budget.
+    void MyWatchdog::leave(void) noexcept
+    {
+        const uint32_t durationMicros = micros() - this->enterMicros_;
+
+        if (durationMicros > LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__MODULE_BUDGET)
+            this->recordOverrun(durationMicros);
+
+        g_PersistentRecord.currentModule = Module::None;
+    }
+
+    /// @brief Resets the watchdog at the end of a loop, and keeps track of the loop period.
+    void MyWatchdog::feed(void) noexcept
+    {
+#if defined(__AVR__) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        wdt_reset();
+#elif defined(ARDUINO_ARCH_STM32) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        IWatchdog.reload();
+#endif
+
+        const uint32_t currentMicros = micros();
+        const uint32_t loopMicros = currentMicros - this->loopMicros_;
+        this->loopMicros_ = currentMicros;
+
+        if (loopMicros > this->maxLoopMicros_)
+            this->maxLoopMicros_ = loopMicros;
+    }
+
+    /// @brief Prints the reset cause, the loop period and the overruns.
+    void MyWatchdog::printStatistics(void) noexcept
+    {
+        Serial.print(F("WDT reset_flags=0x"));
+        Serial.print(this->resetFlags_, HEX);
+        Serial.print(F(" watchdog_resets="));
+        Serial.print(g_PersistentRecord.watchdogResets);
+        Serial.print(F(" max_loop="));
+        Serial.print(this->maxLoopMicros_);
+        Serial.println(F("us"));
+
+        for (uint8_t i = 1U; i < ModuleCount; ++i)
+        {
+            const ModuleStatistics &statistics = this->modules_[i];
+            if (statistics.overruns == 0U)
+                continue;
+
+            Serial.print(F("WDT overruns="));
+            Serial.print(statistics.overruns);
+            Serial.print(F(" worst="));
+            printOverrun(statistics.worst);
+        }
+
+        if (g_PersistentRecord.lastOverrun.module != Module::None)
+        {
+            Serial.print(F("WDT last overrun "));
+            printOverrun(g_PersistentRecord.lastOverrun);
+        }
+    }
+
+    /// @brief Reports the previous reset and arms the watchdog, called before the setup of
+    ///  the other modules so it covers them as well.
+    void MyWatchdog::setup(void) noexcept
+    {
+#if defined(ARDUINO_ARCH_STM32)
+        // Captures and clears the reset flags, which live in the top byte of the CSR.
+        g_ResetFlags = static_cast<uint8_t>(RCC->CSR >> 24);
+        RCC->CSR |= RCC_CSR_RMVF;
+#endif
+
+        this->resetFlags_ = g_ResetFlags;
+
+        // Starts a new record after a power cycle, the RAM contains garbage then.
+        if (g_PersistentRecord.magic != PersistentMagic)
+        {
+            g_PersistentRecord = PersistentRecord();
+            g_PersistentRecord.magic = PersistentMagic;
+        }
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_STM32)
+        // Reports the module the loop hung in.
+#if defined(__AVR__)
+        if (this->resetFlags_ & _BV(WDRF))
+#else
+        if (this->resetFlags_ & (RCC_CSR_IWDGRSTF >> 24))
+#endif
+        {
+            this->watchdogReset_ = true;
+            ++g_PersistentRecord.watchdogResets;
+
+            Serial.print(F("Watchdog reset in "));
+            Serial.print(getModuleName(g_PersistentRecord.currentModule));
+            Serial.print(F(" state="));
+            Serial.println(g_PersistentRecord.currentState);
+        }
+#endif
+
+        if (g_PersistentRecord.lastOverrun.module != Module::None)
+        {
+            Serial.print(F("Last overrun before reset "));
+            printOverrun(g_PersistentRecord.lastOverrun);
+        }
+
+        MyConsole::getInstance().registerCommand(F("wdt"), F("prints the loop overruns and resets, 'wdt clear' clears them"),
+                                                 MyWatchdog::staticHandleCommand, this);
+
+        // The setup of the other modules is covered as well.
+        g_PersistentRecord.currentModule = Module::Setup;
+        g_PersistentRecord.currentState = 0U;
+
+#if defined(__AVR__) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        wdt_enable(LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__TIMEOUT);
+#elif defined(ARDUINO_ARCH_STM32) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        IWatchdog.begin(LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__TIMEOUT);
+#endif
+    }
+
+    /// @brief Marks the end of the setup, called after the setup of the other modules.
+    void MyWatchdog::finishSetup(void) noexcept
+    {
+        g_PersistentRecord.currentModule = Module::None;
+
+#if defined(__AVR__) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        wdt_reset();
+#elif defined(ARDUINO_ARCH_STM32) && LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED
+        IWatchdog.reload();
+#endif
+
+        // Starts measuring the loop period from here on, not from the start of the setup.
+        this->loopMicros_ = micros();
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The loop overrun detector and the hardware watchdog.
+    ///
+    /// Every module call of the main loop is timed against the budget, and the worst overrun
+    ///  of each module is recorded. The hardware watchdog resets the board when the loop hangs,
+    ///  the module and state it hung in and the last overrun are kept in RAM that is not
+    ///  initialized at startup, so they're reported after the reset.
+    class MyWatchdog
+    {
+    public:
+        /// @brief The module called by the main loop.
+        enum class Module : uint8_t
+        {
+            None = 0,
+            Setup = 1,
+            Console = 2,
+            Events = 3,
+            Display = 4,
+            Com = 5,
+            GPS = 6,
+            Memory = 7,
+            Logger = 8,
+            SerialOutput = 9,
+        };
+
+        /// @brief The number of modules, including None.
+        static constexpr uint8_t ModuleCount = 10U;
+
+        /// @brief A single overrun of the loop budget.
+        struct Overrun
+        {
+        public:
+            uint32_t durationMicros;
+            Module module;
+            uint8_t state;
+        };
+
+        /// @brief The overruns of a single module.
+        struct ModuleStatistics
+        {
+        public:
+            uint16_t overruns;
+            Overrun worst;
+        };
+
+        /// @brief The record that survives a reset, it is only valid with the magic.
+        struct PersistentRecord
+        {
+        public:
+            uint16_t magic;
+            uint16_t watchdogResets;
+            Module currentModule;
+            uint8_t currentState;
+            Overrun lastOverrun;
+        };
+
+        /// @brief The magic of a valid persistent record.
+        static constexpr uint16_t PersistentMagic = 0x57D7U;
+
+    private:
+        static MyWatchdog s_Instance;
+
+    public:
+        /// @brief Gets the current watchdog instance.
+        /// @return The watchdog instance.
+        static inline MyWatchdog &getInstance(void) noexcept
+        {
+            return s_Instance;
+        }
+
+        /// @brief Gets the name of the given module.
+        /// @param module the module.
+        /// @return the name, stored in flash.
+        static const __FlashStringHelper *getModuleName(Module module) noexcept;
+
+    private:
+        /// @brief The command that prints or clears the overruns.
+        static void staticHandleCommand(void *u, const char *arguments) noexcept;
+
+    private:
+        ModuleStatistics modules_[ModuleCount];
+        uint32_t enterMicros_;
+        uint32_t loopMicros_;
+        uint32_t maxLoopMicros_;
+        uint8_t resetFlags_;
+        bool watchdogReset_;
+
+    public:
+        /// @brief Constructs a new watchdog instance.
+        MyWatchdog(void) noexcept;
+
+    private:
+        /// @brief Records an overrun of the current module.
+        /// @param durationMicros the duration of the call.
+        void recordOverrun(uint32_t durationMicros) noexcept;
+
+        /// @brief Prints the given overrun.
+        /// @param overrun the overrun.
+        static void printOverrun(const Overrun &overrun) noexcept;
+
+    public:
+        /// @brief Gets the statistics of the given module.
+        /// @param module the module.
+        /// @return the statistics.
+        inline const ModuleStatistics &getModuleStatistics(Module module) const noexcept
+        {
+            return this->modules_[static_cast<uint8_t>(module)];
+        }
+
+        /// @brief Gets the longest loop period since the setup.
+        /// @return the period in microseconds.
+        inline uint32_t getMaxLoopMicros(void) const noexcept
+        {
+            return this->maxLoopMicros_;
+        }
+
+        /// @brief Gets whether the last reset was caused by the watchdog.
+        /// @return true if the watchdog reset the board.
+        inline bool isWatchdogReset(void) const noexcept
+        {
+            return this->watchdogReset_;
+        }
+
+        /// @brief Marks the start of a call of the given module.
+        /// @param module the module.
+        /// @param state the state of the module.
+        void enter(Module module, uint8_t state) noexcept;
+
+        /// @brief Marks the end of the current call, and records it if it overran the budget.
+        void leave(void) noexcept;
+
+        /// @brief Resets the watchdog at the end of a loop, and keeps track of the loop period.
+        void feed(void) noexcept;
+
+        /// @brief Prints the reset cause, the loop period and the overruns.
+        void printStatistics(void) noexcept;
+
+        /// @brief Reports the previous reset and arms the watchdog, called before the setup of
+        ///  the other modules so it covers them as well.
+        void setup(void) noexcept;
+
+        /// @brief Marks the end of the setup, called after the setup of the other modules.
+        void finishSetup(void) noexcept;
+    };
+}
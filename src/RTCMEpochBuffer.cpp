@@ -0,0 +1,159 @@
+#include "RTCMEpochBuffer.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new epoch buffer.
+    /// @param buffer the storage of the buffer.
+    /// @param capacity the size of the storage.
+    /// @param flushCallback the callback that sends the flushed epoch.
+    /// @param flushPolicyCallback the callback that decides if a ready epoch may be flushed.
+    /// @param callbackUserData the user data of the callbacks.
+    RTCMEpochBuffer::RTCMEpochBuffer(uint8_t *buffer, uint16_t capacity,
+                                     FlushCallback flushCallback,
+                                     FlushPolicyCallback flushPolicyCallback,
+                                     void *callbackUserData) noexcept
+        : parser_(),
+          buffer_(buffer),
+          capacity_(capacity),
+          flushCallback_(flushCallback),
+          flushPolicyCallback_(flushPolicyCallback),
+          callbackUserData_(callbackUserData),
+          epochTimes_(),
+          epochSize_(0U),
+          bufferSize_(0U),
+          frames_(0U),
+          droppedFrames_(0U),
+          invalidFrames_(0U),
+          forcedFlushes_(0U),
+          epochConstellations_(0U),
+          epochReady_(false),
+          frameDropped_(false)
+    {
+    }
+
+    /// @brief Empties the buffer and waits for the next frame.
+    void RTCMEpochBuffer::reset(void) noexcept
+    {
+        this->parser_.reset();
+        this->epochSize_ = 0U;
+        this->bufferSize_ = 0U;
+        this->epochConstellations_ = 0U;
+        this->epochReady_ = false;
+        this->frameDropped_ = false;
+    }
+
+    /// @brief Pushes the next byte of the stream.
+    /// @param byte the byte.
+    /// @return false if the byte is not part of a frame.
+    bool RTCMEpochBuffer::push(uint8_t byte) noexcept
+    {
+        // Feeds the byte to the parser, and ignores it if it's not part of a frame.
+        const RTCMParser::Result result = this->parser_.push(byte);
+        if (result == RTCMParser::Result::Skipped)
+            return false;
+
+        // Stores the byte, flushing the complete frames first if the buffer is full. That
+        //  cannot wait for the policy, so a flush it does not allow is counted. The frame is
+        //  dropped if it does not fit in the buffer on its own.
+        if (!this->frameDropped_)
+        {
+            if (this->bufferSize_ >= this->capacity_ && this->epochSize_ > 0U)
+            {
+                if (!this->flushPolicyCallback_(this->callbackUserData_))
+                    ++this->forcedFlushes_;
+
+                this->flush();
+            }
+
+            if (this->bufferSize_ < this->capacity_)
+                this->buffer_[this->bufferSize_++] = byte;
+            else
+                this->frameDropped_ = true;
+        }
+
+        // Waits for the rest of the frame.
+        if (result == RTCMParser::Result::Pending)
+            return true;
+
+        // Discards the corrupted or dropped frame.
+        if (result == RTCMParser::Result::Invalid || this->frameDropped_)
+        {
+            if (this->frameDropped_)
+                ++this->droppedFrames_;
+            else
+                ++this->invalidFrames_;
+
+            this->bufferSize_ = this->epochSize_;
+            this->frameDropped_ = false;
+            return true;
+        }
+
+        const RTCMParser::Frame &frame = this->parser_.getFrame();
+        const uint8_t constellation = frame.msm ? RTCMParser::getMSMConstellation(frame.messageNumber) : 0U;
+        const uint8_t constellationBit = static_cast<uint8_t>(1U << constellation);
+
+        // An MSM of a constellation that already had one in this epoch, with another time,
+        //  means that the last MSM of the previous epoch was lost and that it is complete.
+        if (frame.msm && (this->epochConstellations_ & constellationBit) != 0U &&
+            frame.epochTime != this->epochTimes_[constellation] && this->epochSize_ > 0U)
+        {
+            this->epochReady_ = true;
+            this->epochConstellations_ = 0U;
+            this->tryFlush();
+        }
+
+        // Adds the frame to the epoch.
+        this->epochSize_ = this->bufferSize_;
+        ++this->frames_;
+
+        // The last MSM of an epoch has the multiple message bit cleared, so the epoch
+        //  is complete and can be sent right away.
+        if (frame.msm)
+        {
+            this->epochTimes_[constellation] = frame.epochTime;
+            this->epochConstellations_ |= constellationBit;
+
+            if (!frame.multipleMessage)
+            {
+                this->epochReady_ = true;
+                this->epochConstellations_ = 0U;
+                this->tryFlush();
+            }
+        }
+
+        return true;
+    }
+
+    /// @brief Marks the complete frames as a ready epoch, used when the stream goes idle.
+    void RTCMEpochBuffer::markReady(void) noexcept
+    {
+        if (this->epochSize_ > 0U)
+            this->epochReady_ = true;
+    }
+
+    /// @brief Flushes the epoch if it's ready and the policy allows it.
+    void RTCMEpochBuffer::tryFlush(void) noexcept
+    {
+        // Holds the epoch until it's complete and the policy allows it, epochs that
+        //  complete in the meantime are merged into the same burst.
+        if (!this->epochReady_ || this->epochSize_ == 0U ||
+            !this->flushPolicyCallback_(this->callbackUserData_))
+            return;
+
+        this->flush();
+    }
+
+    /// @brief Flushes the complete frames, and moves the partial frame to the front.
+    void RTCMEpochBuffer::flush(void) noexcept
+    {
+        // Sends the epoch.
+        this->flushCallback_(this->callbackUserData_, this->buffer_, this->epochSize_);
+
+        // Moves the partial frame to the front.
+        memmove(this->buffer_, this->buffer_ + this->epochSize_, this->bufferSize_ - this->epochSize_);
+        this->bufferSize_ -= this->epochSize_;
+        this->epochSize_ = 0U;
+        this->epochReady_ = false;
+    }
+}
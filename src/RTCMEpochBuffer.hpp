@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include "RTCMParser.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Collects the RTCM frames of one epoch, so they can be sent as one burst.
+    ///
+    /// The buffer holds the complete frames of the epoch followed by the partial frame that
+    ///  is being received. An epoch is ready once its last MSM arrives, an MSM of the next
+    ///  epoch arrives, or the owner marks it ready (when the stream goes idle). The owner
+    ///  decides when a ready epoch may be flushed through the flush policy callback.
+    ///
+    /// The epoch times are only compared within a constellation, since they do not share a
+    ///  time scale: GLONASS counts the day of week and time of day in Moscow time, the
+    ///  others the time of week in their own system time.
+    class RTCMEpochBuffer
+    {
+    public:
+        /// @brief Called with the complete frames of the epoch when it's flushed.
+        typedef void (*FlushCallback)(void *, const uint8_t *, uint16_t);
+
+        /// @brief Called to decide whether a ready epoch may be flushed right now.
+        typedef bool (*FlushPolicyCallback)(void *);
+
+    private:
+        RTCMParser parser_;
+        uint8_t *const buffer_;
+        const uint16_t capacity_;
+        const FlushCallback flushCallback_;
+        const FlushPolicyCallback flushPolicyCallback_;
+        void *const callbackUserData_;
+        uint32_t epochTimes_[RTCMParser::MSMConstellationCount];
+        uint16_t epochSize_;
+        uint16_t bufferSize_;
+        uint32_t frames_;
+        uint16_t droppedFrames_;
+        uint16_t invalidFrames_;
+        uint16_t forcedFlushes_;
+        uint8_t epochConstellations_;
+        bool epochReady_;
+        bool frameDropped_;
+
+    public:
+        /// @brief Constructs a new epoch buffer.
+        /// @param buffer the storage of the buffer.
+        /// @param capacity the size of the storage.
+        /// @param flushCallback the callback that sends the flushed epoch.
+        /// @param flushPolicyCallback the callback that decides if a ready epoch may be flushed.
+        /// @param callbackUserData the user data of the callbacks.
+        RTCMEpochBuffer(uint8_t *buffer, uint16_t capacity,
+                        FlushCallback flushCallback,
+                        FlushPolicyCallback flushPolicyCallback,
+                        void *callbackUserData) noexcept;
+
+    public:
+        /// @brief Gets the size of the complete frames in the buffer.
+        /// @return the size of the epoch.
+        inline uint16_t getEpochSize(void) const noexcept
+        {
+            return this->epochSize_;
+        }
+
+        /// @brief Gets the size of the buffered data, the complete frames and the partial frame.
+        /// @return the size of the buffered data.
+        inline uint16_t getBufferSize(void) const noexcept
+        {
+            return this->bufferSize_;
+        }
+
+        /// @brief Gets the number of valid frames added to the epochs.
+        /// @return the number of frames.
+        inline uint32_t getFrames(void) const noexcept
+        {
+            return this->frames_;
+        }
+
+        /// @brief Gets the number of frames dropped because they did not fit in the buffer.
+        /// @return the number of dropped frames.
+        inline uint16_t getDroppedFrames(void) const noexcept
+        {
+            return this->droppedFrames_;
+        }
+
+        /// @brief Gets the number of frames discarded because of a bad header or CRC.
+        /// @return the number of invalid frames.
+        inline uint16_t getInvalidFrames(void) const noexcept
+        {
+            return this->invalidFrames_;
+        }
+
+        /// @brief Gets the number of epochs flushed because the buffer was full while the
+        ///  policy did not allow it, which goes out of the slot.
+        /// @return the number of forced flushes.
+        inline uint16_t getForcedFlushes(void) const noexcept
+        {
+            return this->forcedFlushes_;
+        }
+
+        /// @brief Gets the parser, which holds the information of the last complete frame.
+        /// @return the parser.
+        inline const RTCMParser &getParser(void) const noexcept
+        {
+            return this->parser_;
+        }
+
+        /// @brief Empties the buffer and waits for the next frame.
+        void reset(void) noexcept;
+
+        /// @brief Pushes the next byte of the stream.
+        /// @param byte the byte.
+        /// @return false if the byte is not part of a frame.
+        bool push(uint8_t byte) noexcept;
+
+        /// @brief Marks the complete frames as a ready epoch, used when the stream goes idle.
+        void markReady(void) noexcept;
+
+        /// @brief Flushes the epoch if it's ready and the policy allows it.
+        void tryFlush(void) noexcept;
+
+        /// @brief Flushes the complete frames, and moves the partial frame to the front.
+        void flush(void) noexcept;
+    };
+}
@@ -0,0 +1,63 @@
+#include "RTCMFanout.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new fan-out.
+    /// @param sinks the storage of the sinks.
+    /// @param maxSinks the number of sinks that fit in the storage.
+    RTCMFanout::RTCMFanout(Sink *sinks, uint8_t maxSinks) noexcept
+        : sinks_(sinks),
+          maxSinks_(maxSinks),
+          sinkCount_(0U)
+    {
+    }
+
+    /// @brief Registers the given sink.
+    /// @param name the name of the sink.
+    /// @param writeCallback the callback that writes an epoch to the sink.
+    /// @param capacityCallback the callback that reports the capacity, or null if the sink
+    ///  accepts everything.
+    /// @param userData the user data passed to the callbacks.
+    /// @return false if there is no room for another sink.
+    bool RTCMFanout::addSink(const char *name, WriteCallback writeCallback, CapacityCallback capacityCallback, void *userData) noexcept
+    {
+        // Makes sure there is room for the sink.
+        if (this->sinkCount_ >= this->maxSinks_)
+            return false;
+
+        // Stores the sink.
+        Sink &sink = this->sinks_[this->sinkCount_++];
+        sink.name = name;
+        sink.writeCallback = writeCallback;
+        sink.capacityCallback = capacityCallback;
+        sink.userData = userData;
+        sink.deliveredEpochs = 0U;
+        sink.droppedEpochs = 0U;
+
+        return true;
+    }
+
+    /// @brief Delivers the given epoch to every sink that has room for it.
+    /// @param epoch the complete frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @param handle the frame holding the epoch in the pool, or NoBlock.
+    void RTCMFanout::deliver(const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle handle) noexcept
+    {
+        for (uint8_t i = 0U; i < this->sinkCount_; ++i)
+        {
+            Sink &sink = this->sinks_[i];
+
+            // Drops the epoch for a sink that cannot take it right now, instead of waiting for it.
+            if (sink.capacityCallback != nullptr && sink.capacityCallback(sink.userData) < epochSize)
+            {
+                ++sink.droppedEpochs;
+                continue;
+            }
+
+            if (sink.writeCallback(sink.userData, epoch, epochSize, handle))
+                ++sink.deliveredEpochs;
+            else
+                ++sink.droppedEpochs;
+        }
+    }
+}
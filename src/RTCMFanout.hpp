@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include "RTCMFramePool.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Delivers every flushed RTCM epoch to the registered sinks, in the order they were
+    ///  added, without copying it.
+    ///
+    /// Every sink reports how much it can accept right now, an epoch that does not fit is
+    ///  dropped for that sink only, so a slow sink never stalls the others. The epoch is only
+    ///  valid during the delivery, sinks that need it later retain its frame in the pool.
+    class RTCMFanout
+    {
+    public:
+        /// @brief Called with the complete frames of an epoch and the frame holding them in the
+        ///  pool (NoBlock if the pool was full), returns false if it was dropped.
+        typedef bool (*WriteCallback)(void *, const uint8_t *, uint16_t, RTCMFramePool::Handle);
+
+        /// @brief Called to get the number of bytes the sink accepts without blocking.
+        typedef uint16_t (*CapacityCallback)(void *);
+
+        /// @brief A single registered sink and its counters.
+        struct Sink
+        {
+        public:
+            const char *name;
+            WriteCallback writeCallback;
+            CapacityCallback capacityCallback;
+            void *userData;
+            uint32_t deliveredEpochs;
+            uint32_t droppedEpochs;
+        };
+
+    private:
+        Sink *const sinks_;
+        const uint8_t maxSinks_;
+        uint8_t sinkCount_;
+
+    public:
+        /// @brief Constructs a new fan-out.
+        /// @param sinks the storage of the sinks.
+        /// @param maxSinks the number of sinks that fit in the storage.
+        RTCMFanout(Sink *sinks, uint8_t maxSinks) noexcept;
+
+    public:
+        /// @brief Gets the number of registered sinks.
+        /// @return the number of sinks.
+        inline uint8_t getSinkCount(void) const noexcept
+        {
+            return this->sinkCount_;
+        }
+
+        /// @brief Gets the sink at the given index.
+        /// @param index the index of the sink.
+        /// @return the sink.
+        inline const Sink &getSink(uint8_t index) const noexcept
+        {
+            return this->sinks_[index];
+        }
+
+        /// @brief Registers the given sink.
+        /// @param name the name of the sink.
+        /// @param writeCallback the callback that writes an epoch to the sink.
+        /// @param capacityCallback the callback that reports the capacity, or null if the sink
+        ///  accepts everything.
+        /// @param userData the user data passed to the callbacks.
+        /// @return false if there is no room for another sink.
+        bool addSink(const char *name, WriteCallback writeCallback, CapacityCallback capacityCallback, void *userData) noexcept;
+
+        /// @brief Delivers the given epoch to every sink that has room for it.
+        /// @param epoch the complete frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @param handle the frame holding the epoch in the pool, or NoBlock.
+        void deliver(const uint8_t *epoch, uint16_t epochSize, RTCMFramePool::Handle handle) noexcept;
+    };
+}
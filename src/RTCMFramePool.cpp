@@ -0,0 +1,165 @@
+#include "RTCMFramePool.hpp"
+#include <string.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new frame pool.
+    /// @param blocks the storage of the blocks.
+    /// @param blockCount the number of blocks, less than NoBlock.
+    RTCMFramePool::RTCMFramePool(Block *blocks, uint8_t blockCount) noexcept
+        : blocks_(blocks),
+          blockCount_(blockCount),
+          freeHead_(NoBlock),
+          freeBlocks_(0U),
+          statistics_()
+    {
+        this->reset();
+    }
+
+    /// @brief Returns every block to the pool, the handles that are still held become invalid.
+    void RTCMFramePool::reset(void) noexcept
+    {
+        // Links all the blocks into the free list.
+        for (uint8_t i = 0U; i < this->blockCount_; ++i)
+        {
+            this->blocks_[i].next = i + 1U < this->blockCount_ ? static_cast<uint8_t>(i + 1U) : NoBlock;
+            this->blocks_[i].references = 0U;
+        }
+
+        this->freeHead_ = this->blockCount_ > 0U ? 0U : NoBlock;
+        this->freeBlocks_ = this->blockCount_;
+        this->statistics_.minFreeBlocks = this->blockCount_;
+    }
+
+    /// @brief Stores a copy of the given data as a new frame, holding one reference.
+    /// @param data the data.
+    /// @param size the size of the data.
+    /// @return the frame, or NoBlock if there are not enough free blocks.
+    RTCMFramePool::Handle RTCMFramePool::store(const uint8_t *data, uint16_t size) noexcept
+    {
+        const uint16_t blockCount = size > 0U ? (size + BlockSize - 1U) / BlockSize : 1U;
+
+        // Stores the whole frame or nothing, a partial frame is useless.
+        if (blockCount > this->freeBlocks_)
+        {
+            ++this->statistics_.failed;
+            return NoBlock;
+        }
+
+        const Handle handle = this->freeHead_;
+        uint8_t index = handle;
+        uint16_t offset = 0U;
+
+        // Copies the data into the blocks at the head of the free list, which stay linked.
+        for (uint16_t i = 0U; i < blockCount; ++i)
+        {
+            Block &block = this->blocks_[index];
+            const uint16_t blockSize = size - offset < BlockSize ? size - offset : BlockSize;
+
+            memcpy(block.data, &data[offset], blockSize);
+            offset += blockSize;
+
+            if (i + 1U == blockCount)
+            {
+                this->freeHead_ = block.next;
+                block.next = NoBlock;
+            }
+            else
+            {
+                index = block.next;
+            }
+        }
+
+        this->blocks_[handle].frameSize = size;
+        this->blocks_[handle].references = 1U;
+
+        this->freeBlocks_ -= static_cast<uint8_t>(blockCount);
+        if (this->freeBlocks_ < this->statistics_.minFreeBlocks)
+            this->statistics_.minFreeBlocks = this->freeBlocks_;
+
+        ++this->statistics_.stored;
+
+        return handle;
+    }
+
+    /// @brief Adds a reference to the given frame.
+    /// @param handle the frame.
+    void RTCMFramePool::retain(Handle handle) noexcept
+    {
+        ++this->blocks_[handle].references;
+    }
+
+    /// @brief Removes a reference from the given frame, and returns its blocks to the pool
+    ///  if it was the last one.
+    /// @param handle the frame.
+    void RTCMFramePool::release(Handle handle) noexcept
+    {
+        Block &head = this->blocks_[handle];
+
+        if (--head.references > 0U)
+            return;
+
+        // Finds the end of the chain, and puts the whole chain in front of the free list.
+        uint8_t index = handle;
+        uint8_t blockCount = 1U;
+
+        while (this->blocks_[index].next != NoBlock)
+        {
+            index = this->blocks_[index].next;
+            ++blockCount;
+        }
+
+        this->blocks_[index].next = this->freeHead_;
+        this->freeHead_ = handle;
+        this->freeBlocks_ += blockCount;
+    }
+
+    /// @brief Gets the contiguous part of the frame at the given offset, up to the end of
+    ///  its block.
+    /// @param handle the frame.
+    /// @param offset the offset in the frame, less than its size.
+    /// @param size the size of the contiguous part.
+    /// @return the data at the offset.
+    const uint8_t *RTCMFramePool::getSegment(Handle handle, uint16_t offset, uint16_t &size) const noexcept
+    {
+        const uint16_t frameSize = this->blocks_[handle].frameSize;
+        uint8_t index = handle;
+
+        // Walks to the block that holds the offset.
+        for (uint16_t blockOffset = offset / BlockSize; blockOffset > 0U; --blockOffset)
+            index = this->blocks_[index].next;
+
+        const uint8_t inBlock = static_cast<uint8_t>(offset % BlockSize);
+
+        size = frameSize - offset < static_cast<uint16_t>(BlockSize - inBlock) ? frameSize - offset : BlockSize - inBlock;
+
+        return &this->blocks_[index].data[inBlock];
+    }
+
+    /// @brief Copies a part of the frame.
+    /// @param handle the frame.
+    /// @param offset the offset in the frame.
+    /// @param buffer the buffer to copy to.
+    /// @param size the number of bytes to copy.
+    /// @return the number of bytes copied, less if the frame ends first.
+    uint16_t RTCMFramePool::read(Handle handle, uint16_t offset, uint8_t *buffer, uint16_t size) const noexcept
+    {
+        const uint16_t frameSize = this->blocks_[handle].frameSize;
+        uint16_t copied = 0U;
+
+        while (copied < size && offset < frameSize)
+        {
+            uint16_t segmentSize;
+            const uint8_t *segment = this->getSegment(handle, offset, segmentSize);
+
+            if (segmentSize > size - copied)
+                segmentSize = size - copied;
+
+            memcpy(&buffer[copied], segment, segmentSize);
+            copied += segmentSize;
+            offset += segmentSize;
+        }
+
+        return copied;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief A static pool of fixed-size blocks that holds RTCM frames without the heap.
+    ///
+    /// A frame is stored once in a chain of blocks, and is shared by reference counting, so
+    ///  the transmit queue, the repair cache and the other consumers can hold the same frame
+    ///  at the same time without copies. The chain is returned to the pool once the last
+    ///  holder releases it.
+    class RTCMFramePool
+    {
+    public:
+        /// @brief The size of the data in a block, the STM32 build takes larger blocks so that
+        ///  two of its larger epochs stay addressable by the 8-bit index.
+#if defined(ARDUINO_ARCH_STM32)
+        static constexpr uint8_t BlockSize = 128U;
+#else
+        static constexpr uint8_t BlockSize = 32U;
+#endif
+
+        /// @brief The index that marks the end of a chain, or the absence of a frame.
+        static constexpr uint8_t NoBlock = 0xFFU;
+
+        /// @brief A frame, the index of the first block of its chain.
+        typedef uint8_t Handle;
+
+        /// @brief A single block, the size and the references are kept in the first block.
+        struct Block
+        {
+        public:
+            uint8_t data[BlockSize];
+            uint16_t frameSize;
+            uint8_t next;
+            uint8_t references;
+        };
+
+        /// @brief The statistics of the pool.
+        struct Statistics
+        {
+        public:
+            uint32_t stored;
+            uint32_t failed;
+            uint8_t minFreeBlocks;
+        };
+
+    private:
+        Block *const blocks_;
+        const uint8_t blockCount_;
+        uint8_t freeHead_;
+        uint8_t freeBlocks_;
+        Statistics statistics_;
+
+    public:
+        /// @brief Constructs a new frame pool.
+        /// @param blocks the storage of the blocks.
+        /// @param blockCount the number of blocks, less than NoBlock.
+        RTCMFramePool(Block *blocks, uint8_t blockCount) noexcept;
+
+    public:
+        /// @brief Gets the number of free blocks.
+        /// @return the number of free blocks.
+        inline uint8_t getFreeBlocks(void) const noexcept
+        {
+            return this->freeBlocks_;
+        }
+
+        /// @brief Gets the statistics of the pool.
+        /// @return the statistics.
+        inline const Statistics &getStatistics(void) const noexcept
+        {
+            return this->statistics_;
+        }
+
+        /// @brief Gets the size of the given frame.
+        /// @param handle the frame.
+        /// @return the size of the frame.
+        inline uint16_t getSize(Handle handle) const noexcept
+        {
+            return this->blocks_[handle].frameSize;
+        }
+
+        /// @brief Returns every block to the pool, the handles that are still held become invalid.
+        void reset(void) noexcept;
+
+        /// @brief Stores a copy of the given data as a new frame, holding one reference.
+        /// @param data the data.
+        /// @param size the size of the data.
+        /// @return the frame, or NoBlock if there are not enough free blocks.
+        Handle store(const uint8_t *data, uint16_t size) noexcept;
+
+        /// @brief Adds a reference to the given frame.
+        /// @param handle the frame.
+        void retain(Handle handle) noexcept;
+
+        /// @brief Removes a reference from the given frame, and returns its blocks to the pool
+        ///  if it was the last one.
+        /// @param handle the frame.
+        void release(Handle handle) noexcept;
+
+        /// @brief Gets the contiguous part of the frame at the given offset, up to the end of
+        ///  its block.
+        /// @param handle the frame.
+        /// @param offset the offset in the frame, less than its size.
+        /// @param size the size of the contiguous part.
+        /// @return the data at the offset.
+        const uint8_t *getSegment(Handle handle, uint16_t offset, uint16_t &size) const noexcept;
+
+        /// @brief Copies a part of the frame.
+        /// @param handle the frame.
+        /// @param offset the offset in the frame.
+        /// @param buffer the buffer to copy to.
+        /// @param size the number of bytes to copy.
+        /// @return the number of bytes copied, less if the frame ends first.
+        uint16_t read(Handle handle, uint16_t offset, uint8_t *buffer, uint16_t size) const noexcept;
+    };
+}
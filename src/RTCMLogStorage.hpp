@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The storage device the RTCM log is written to, implemented by the SD card on the
+    ///  target and by regular files on the host.
+    class RTCMLogStorage
+    {
+    public:
+        /// @brief Begins the storage device.
+        /// @return false if the device is not available.
+        virtual bool begin(void) noexcept = 0;
+
+        /// @brief Checks whether a file with the given name exists.
+        /// @param name the name of the file.
+        /// @return true if it exists.
+        virtual bool exists(const char *name) noexcept = 0;
+
+        /// @brief Creates the given file, or opens it for appending if it exists, as the log file.
+        /// @param name the name of the file.
+        /// @return false if the file could not be opened.
+        virtual bool open(const char *name) noexcept = 0;
+
+        /// @brief Appends the given data to the log file.
+        /// @param data the data.
+        /// @param size the size of the data.
+        /// @return false if the data could not be written.
+        virtual bool write(const uint8_t *data, uint16_t size) noexcept = 0;
+
+        /// @brief Commits the written data and the size of the log file to the device.
+        /// @return false if the data could not be committed.
+        virtual bool sync(void) noexcept = 0;
+
+        /// @brief Closes the log file.
+        virtual void close(void) noexcept = 0;
+
+        /// @brief Appends the given data to another file, opening and closing it again.
+        /// @param name the name of the file.
+        /// @param data the data.
+        /// @param size the size of the data.
+        /// @return false if the data could not be written.
+        virtual bool append(const char *name, const uint8_t *data, uint16_t size) noexcept = 0;
+    };
+}
@@ -0,0 +1,240 @@
+#include "RTCMLogWriter.hpp"
+#include <stdio.h>
+#include <string.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The name of the index file.
+    static const char s_IndexFileName[] = "RTCMLOG.IDX";
+
+    /// @brief Constructs a new log writer.
+    /// @param storage the storage to write to.
+    /// @param blocks the storage of the blocks, blockCount times BlockSize.
+    /// @param blockCount the number of blocks.
+    /// @param maxFileSize the size at which the next file is started.
+    RTCMLogWriter::RTCMLogWriter(RTCMLogStorage &storage, uint8_t *blocks, uint8_t blockCount, uint32_t maxFileSize) noexcept
+        : storage_(storage),
+          blocks_(blocks),
+          blockCount_(blockCount),
+          maxFileSize_(maxFileSize),
+          statistics_(),
+          fileSize_(0U),
+          fileIndex_(0U),
+          headOffset_(0U),
+          headBlock_(0U),
+          tailBlock_(0U),
+          fullBlocks_(0U),
+          open_(false)
+    {
+    }
+
+    /// @brief Formats the name of the log file with the given index.
+    /// @param name the name to fill, at least 13 characters.
+    /// @param index the index of the file.
+    void RTCMLogWriter::formatFileName(char *name, uint16_t index) noexcept
+    {
+        memcpy(name, "RTCM0000.LOG", 13U);
+
+        for (uint8_t i = 7U; i >= 4U; --i)
+        {
+            name[i] = static_cast<char>('0' + index % 10U);
+            index /= 10U;
+        }
+    }
+
+    /// @brief Opens the log file with the current index, and adds it to the index file.
+    /// @param currentMillis the current time.
+    /// @return false if the file could not be opened.
+    bool RTCMLogWriter::openFile(uint32_t currentMillis) noexcept
+    {
+        char name[13];
+        formatFileName(name, this->fileIndex_);
+
+        if (!this->storage_.open(name))
+            return false;
+
+        this->fileSize_ = 0U;
+
+        // Adds the file to the index, a failure only affects the index.
+        char line[32];
+        const int lineSize = snprintf(line, sizeof(line), "%s %lu\n", name, static_cast<unsigned long>(currentMillis));
+        this->storage_.append(s_IndexFileName, reinterpret_cast<const uint8_t *>(line), static_cast<uint16_t>(lineSize));
+
+        return true;
+    }
+
+    /// @brief Copies the given data into the head block, moving to the next block when it's full.
+    /// @param data the data.
+    /// @param size the size of the data.
+    void RTCMLogWriter::copy(const uint8_t *data, uint16_t size) noexcept
+    {
+        while (size > 0U)
+        {
+            const uint16_t room = BlockSize - this->headOffset_;
+            const uint16_t part = size < room ? size : room;
+
+            memcpy(this->blocks_ + static_cast<uint16_t>(this->headBlock_) * BlockSize + this->headOffset_, data, part);
+            this->headOffset_ += part;
+            data += part;
+            size -= part;
+
+            // Hands the block over to the storage once it's full.
+            if (this->headOffset_ == BlockSize)
+            {
+                this->headOffset_ = 0U;
+                this->headBlock_ = static_cast<uint8_t>((this->headBlock_ + 1U) % this->blockCount_);
+                ++this->fullBlocks_;
+            }
+        }
+    }
+
+    /// @brief Starts logging to the file after the last existing one.
+    /// @param currentMillis the current time.
+    /// @return false if the storage or the file could not be opened.
+    bool RTCMLogWriter::begin(uint32_t currentMillis) noexcept
+    {
+        if (!this->storage_.begin())
+            return false;
+
+        // Continues after the last file, so the files of an earlier run are kept.
+        char name[13];
+        for (this->fileIndex_ = 0U; this->fileIndex_ < MaxFiles; ++this->fileIndex_)
+        {
+            formatFileName(name, this->fileIndex_);
+            if (!this->storage_.exists(name))
+                break;
+        }
+
+        if (this->fileIndex_ >= MaxFiles || !this->openFile(currentMillis))
+            return false;
+
+        this->headOffset_ = 0U;
+        this->headBlock_ = 0U;
+        this->tailBlock_ = 0U;
+        this->fullBlocks_ = 0U;
+        this->open_ = true;
+
+        return true;
+    }
+
+    /// @brief Stops logging, the pending blocks are discarded.
+    void RTCMLogWriter::end(void) noexcept
+    {
+        if (this->open_)
+            this->storage_.close();
+
+        this->open_ = false;
+        this->headOffset_ = 0U;
+        this->fullBlocks_ = 0U;
+    }
+
+    /// @brief Appends a record to the blocks, never writes to the storage.
+    /// @param currentMillis the time of the record.
+    /// @param data the data of the record.
+    /// @param size the size of the data.
+    /// @return false if the record did not fit and was dropped.
+    bool RTCMLogWriter::append(uint32_t currentMillis, const uint8_t *data, uint16_t size) noexcept
+    {
+        const uint32_t recordSize = sizeof(RecordHeader) + static_cast<uint32_t>(size);
+        // Drops the whole record if it does not fit, a partial record is useless.
+        if (recordSize > this->getFreeSize())
+        {
+            ++this->statistics_.droppedRecords;
+            return false;
+        }
+
+        RecordHeader header;
+        header.marker = RecordMarker;
+        header.millis = currentMillis;
+        header.size = size;
+
+        this->copy(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+        this->copy(data, size);
+
+        ++this->statistics_.records;
+        return true;
+    }
+
+    /// @brief Appends every frame of the given epoch as a record of its own, so a single
+    ///  frame only needs one free block.
+    /// @param currentMillis the time of the records.
+    /// @param epoch the complete frames of the epoch.
+    /// @param epochSize the size of the epoch.
+    /// @return the number of frames that were dropped.
+    uint8_t RTCMLogWriter::appendFrames(uint32_t currentMillis, const uint8_t *epoch, uint16_t epochSize) noexcept
+    {
+        uint16_t offset = 0U;
+        uint8_t dropped = 0U;
+
+        while (offset + RTCMParser::HeaderSize <= epochSize)
+        {
+            // Gets the size of the frame from the length in its header.
+            const uint16_t frameSize = RTCMParser::HeaderSize + RTCMParser::CrcSize +
+                                       ((static_cast<uint16_t>(epoch[offset + 1U] & 0x03U) << 8) | epoch[offset + 2U]);
+
+            if (offset + frameSize > epochSize)
+                break;
+
+            if (!this->append(currentMillis, epoch + offset, frameSize))
+                ++dropped;
+
+            offset += frameSize;
+        }
+
+        return dropped;
+    }
+
+    /// @brief Pads the partially filled head block with zeros, so it gets written.
+    void RTCMLogWriter::pad(void) noexcept
+    {
+        if (this->headOffset_ == 0U)
+            return;
+
+        memset(this->blocks_ + static_cast<uint16_t>(this->headBlock_) * BlockSize + this->headOffset_, 0,
+               BlockSize - this->headOffset_);
+
+        this->headOffset_ = 0U;
+        this->headBlock_ = static_cast<uint8_t>((this->headBlock_ + 1U) % this->blockCount_);
+        ++this->fullBlocks_;
+    }
+
+    /// @brief Writes at most one full block to the storage, and rotates the file when it's full.
+    /// @param currentMillis the current time.
+    /// @return false if the write failed.
+    bool RTCMLogWriter::service(uint32_t currentMillis) noexcept
+    {
+        if (!this->open_ || this->fullBlocks_ == 0U)
+            return true;
+
+        const bool written = this->storage_.write(this->blocks_ + static_cast<uint16_t>(this->tailBlock_) * BlockSize, BlockSize);
+
+        // Frees the block either way, retrying a failing device would only stall the log.
+        this->tailBlock_ = static_cast<uint8_t>((this->tailBlock_ + 1U) % this->blockCount_);
+        --this->fullBlocks_;
+
+        if (!written)
+        {
+            ++this->statistics_.writeErrors;
+            return false;
+        }
+
+        ++this->statistics_.blocksWritten;
+        this->fileSize_ += BlockSize;
+
+        // Starts the next file once this one is full.
+        if (this->fileSize_ >= this->maxFileSize_ && this->fileIndex_ + 1U < MaxFiles)
+        {
+            this->storage_.close();
+            ++this->fileIndex_;
+            ++this->statistics_.rotations;
+
+            if (!this->openFile(currentMillis))
+            {
+                this->open_ = false;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stdint.h>
+#include "RTCMLogStorage.hpp"
+#include "RTCMParser.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Write-behind logger of the RTCM stream.
+    ///
+    /// The appended records are copied into a ring of RAM blocks, and only full blocks are
+    ///  written to the storage, one at a time when the owner services the writer. Appending
+    ///  never touches the storage, a record that does not fit in the free blocks is dropped.
+    ///  A record of up to one block less than the ring always fits once the full blocks have
+    ///  been written.
+    ///
+    /// Every record is a marker, the time in milliseconds, the size and the data. The log is
+    ///  split in files named RTCM0000.LOG, RTCM0001.LOG, and so on, which continue each other
+    ///  (a record may span two files). The index file lists every file with the time it was
+    ///  started at. A block that is padded before it's full is padded with zeros, which the
+    ///  reader skips until the next marker.
+    class RTCMLogWriter
+    {
+    public:
+        /// @brief The size of a block, the sector size of an SD card.
+        static constexpr uint16_t BlockSize = 512U;
+
+        /// @brief The marker in front of every record.
+        static constexpr uint8_t RecordMarker = 0xA5U;
+
+        /// @brief The number of log files before the name runs out of digits.
+        static constexpr uint16_t MaxFiles = 10000U;
+
+        /// @brief The header of a record.
+        struct __attribute__((packed)) RecordHeader
+        {
+        public:
+            uint8_t marker;
+            uint32_t millis;
+            uint16_t size;
+        };
+
+        /// @brief The statistics of the writer.
+        struct Statistics
+        {
+        public:
+            uint32_t records;
+            uint32_t droppedRecords;
+            uint32_t blocksWritten;
+            uint32_t writeErrors;
+            uint16_t rotations;
+        };
+
+    private:
+        RTCMLogStorage &storage_;
+        uint8_t *const blocks_;
+        const uint8_t blockCount_;
+        const uint32_t maxFileSize_;
+        Statistics statistics_;
+        uint32_t fileSize_;
+        uint16_t fileIndex_;
+        uint16_t headOffset_;
+        uint8_t headBlock_;
+        uint8_t tailBlock_;
+        uint8_t fullBlocks_;
+        bool open_;
+
+    public:
+        /// @brief Constructs a new log writer.
+        /// @param storage the storage to write to.
+        /// @param blocks the storage of the blocks, blockCount times BlockSize.
+        /// @param blockCount the number of blocks.
+        /// @param maxFileSize the size at which the next file is started.
+        RTCMLogWriter(RTCMLogStorage &storage, uint8_t *blocks, uint8_t blockCount, uint32_t maxFileSize) noexcept;
+
+    private:
+        /// @brief Formats the name of the log file with the given index.
+        /// @param name the name to fill, at least 13 characters.
+        /// @param index the index of the file.
+        static void formatFileName(char *name, uint16_t index) noexcept;
+
+        /// @brief Opens the log file with the current index, and adds it to the index file.
+        /// @param currentMillis the current time.
+        /// @return false if the file could not be opened.
+        bool openFile(uint32_t currentMillis) noexcept;
+
+        /// @brief Copies the given data into the head block, moving to the next block when it's full.
+        /// @param data the data.
+        /// @param size the size of the data.
+        void copy(const uint8_t *data, uint16_t size) noexcept;
+
+    public:
+        /// @brief Gets the statistics.
+        /// @return the statistics.
+        inline const Statistics &getStatistics(void) const noexcept
+        {
+            return this->statistics_;
+        }
+
+        /// @brief Gets the index of the current log file.
+        /// @return the file index.
+        inline uint16_t getFileIndex(void) const noexcept
+        {
+            return this->fileIndex_;
+        }
+
+        /// @brief Gets whether there are full blocks waiting to be written.
+        /// @return true if there is a block to write.
+        inline bool hasPendingBlocks(void) const noexcept
+        {
+            return this->fullBlocks_ > 0U;
+        }
+
+        /// @brief Gets whether there is data in the block being filled.
+        /// @return true if the head block is partially filled.
+        inline bool hasPartialBlock(void) const noexcept
+        {
+            return this->headOffset_ > 0U;
+        }
+
+        /// @brief Gets the number of bytes that can be appended right now, including the
+        ///  headers of the records.
+        /// @return the free size, zero if no log file is open.
+        inline uint32_t getFreeSize(void) const noexcept
+        {
+            return this->open_ ? static_cast<uint32_t>(this->blockCount_ - this->fullBlocks_) * BlockSize - this->headOffset_ : 0U;
+        }
+
+        /// @brief Gets whether a log file is open.
+        /// @return true if the writer is started.
+        inline bool isOpen(void) const noexcept
+        {
+            return this->open_;
+        }
+
+        /// @brief Starts logging to the file after the last existing one.
+        /// @param currentMillis the current time.
+        /// @return false if the storage or the file could not be opened.
+        bool begin(uint32_t currentMillis) noexcept;
+
+        /// @brief Stops logging, the pending blocks are discarded.
+        void end(void) noexcept;
+
+        /// @brief Appends a record to the blocks, never writes to the storage.
+        /// @param currentMillis the time of the record.
+        /// @param data the data of the record.
+        /// @param size the size of the data.
+        /// @return false if the record did not fit and was dropped.
+        bool append(uint32_t currentMillis, const uint8_t *data, uint16_t size) noexcept;
+
+        /// @brief Appends every frame of the given epoch as a record of its own, so a single
+        ///  frame only needs one free block.
+        /// @param currentMillis the time of the records.
+        /// @param epoch the complete frames of the epoch.
+        /// @param epochSize the size of the epoch.
+        /// @return the number of frames that were dropped.
+        uint8_t appendFrames(uint32_t currentMillis, const uint8_t *epoch, uint16_t epochSize) noexcept;
+
+        /// @brief Pads the partially filled head block with zeros, so it gets written.
+        void pad(void) noexcept;
+
+        /// @brief Writes at most one full block to the storage, and rotates the file when it's full.
+        /// @param currentMillis the current time.
+        /// @return false if the write failed.
+        bool service(uint32_t currentMillis) noexcept;
+    };
+}
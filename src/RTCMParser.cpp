@@ -0,0 +1,155 @@
+#include "RTCMParser.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Updates the CRC-24Q with the given byte.
+    /// @param crc the current CRC.
+    /// @param byte the byte.
+    /// @return the new CRC.
+    uint32_t RTCMParser::updateCrc(uint32_t crc, uint8_t byte) noexcept
+    {
+        crc ^= static_cast<uint32_t>(byte) << 16;
+
+        for (uint8_t i = 0U; i < 8U; ++i)
+        {
+            crc <<= 1;
+
+            if ((crc & 0x1000000UL) != 0U)
+                crc ^= 0x1864CFBUL;
+        }
+
+        return crc & 0xFFFFFFUL;
+    }
+
+    /// @brief Checks whether the given message number is a multiple signal message (MSM).
+    /// @param messageNumber the message number.
+    /// @return true if it is an MSM.
+    bool RTCMParser::isMSM(uint16_t messageNumber) noexcept
+    {
+        const uint8_t type = messageNumber % 10U;
+
+        return messageNumber >= 1071U && messageNumber <= 1137U && type >= 1U && type <= 7U;
+    }
+
+    /// @brief Constructs a new parser waiting for a preamble.
+    RTCMParser::RTCMParser(void) noexcept
+        : frame_(),
+          messageHeader_(),
+          crc_(0U),
+          receivedCrc_(0U),
+          payloadSize_(0U),
+          received_(0U),
+          state_(State::Preamble)
+    {
+    }
+
+    /// @brief Discards the current frame and waits for the next preamble.
+    void RTCMParser::reset(void) noexcept
+    {
+        this->received_ = 0U;
+        this->state_ = State::Preamble;
+    }
+
+    /// @brief Pushes the next byte of the stream.
+    /// @param byte the byte.
+    /// @return Skipped if the byte is not part of a frame, Pending if the frame is incomplete,
+    ///  Frame if it completed a valid frame and Invalid if it completed a corrupted frame.
+    RTCMParser::Result RTCMParser::push(uint8_t byte) noexcept
+    {
+        switch (this->state_)
+        {
+        case State::Preamble:
+            // Skips everything until the preamble.
+            if (byte != Preamble)
+                return Result::Skipped;
+
+            this->crc_ = updateCrc(0U, byte);
+            this->received_ = 1U;
+            this->state_ = State::Length;
+            return Result::Pending;
+        case State::Length:
+            this->crc_ = updateCrc(this->crc_, byte);
+
+            // The first length byte holds 6 reserved bits, which must be zero.
+            if (++this->received_ == 2U)
+            {
+                if ((byte & 0xFCU) != 0U)
+                {
+                    this->reset();
+                    return Result::Invalid;
+                }
+
+                this->payloadSize_ = static_cast<uint16_t>(byte & 0x03U) << 8;
+                return Result::Pending;
+            }
+
+            this->payloadSize_ |= byte;
+            this->state_ = this->payloadSize_ > 0U ? State::Payload : State::Crc;
+            this->receivedCrc_ = 0U;
+            return Result::Pending;
+        case State::Payload:
+        {
+            this->crc_ = updateCrc(this->crc_, byte);
+
+            // Keeps the start of the payload to decode the message header.
+            const uint16_t payloadIndex = this->received_++ - HeaderSize;
+            if (payloadIndex < MessageHeaderSize)
+                this->messageHeader_[payloadIndex] = byte;
+
+            if (payloadIndex + 1U == this->payloadSize_)
+                this->state_ = State::Crc;
+
+            return Result::Pending;
+        }
+        case State::Crc:
+            this->receivedCrc_ = (this->receivedCrc_ << 8) | byte;
+
+            // Waits for all the bytes of the CRC.
+            if (++this->received_ < HeaderSize + this->payloadSize_ + CrcSize)
+                return Result::Pending;
+
+            this->state_ = State::Preamble;
+
+            if (this->receivedCrc_ != this->crc_)
+                return Result::Invalid;
+
+            break;
+        default:
+            return Result::Skipped;
+        }
+
+        // Decodes the message number from the first 12 bits of the payload.
+        const uint8_t *h = this->messageHeader_;
+        Frame &frame = this->frame_;
+
+        frame.size = this->received_;
+        frame.crc = this->crc_;
+        frame.messageNumber = this->payloadSize_ >= 2U ? static_cast<uint16_t>((h[0] << 4) | (h[1] >> 4)) : 0U;
+        frame.msm = this->payloadSize_ >= MessageHeaderSize && isMSM(frame.messageNumber);
+
+        // The MSM header continues with the station (12 bits), the epoch time (30 bits)
+        //  and the multiple message bit, and has the 64-bit satellite mask at bit 73.
+        if (frame.msm)
+        {
+            frame.epochTime = ((static_cast<uint32_t>(h[3]) << 22) |
+                               (static_cast<uint32_t>(h[4]) << 14) |
+                               (static_cast<uint32_t>(h[5]) << 6) |
+                               (static_cast<uint32_t>(h[6]) >> 2)) &
+                              0x3FFFFFFFUL;
+            frame.multipleMessage = (h[6] & 0x02U) != 0U;
+
+            uint8_t satellites = static_cast<uint8_t>(__builtin_popcount(h[9] & 0x7FU) + (h[17] >> 7));
+            for (uint8_t i = 10U; i < 17U; ++i)
+                satellites += static_cast<uint8_t>(__builtin_popcount(h[i]));
+            frame.satellites = satellites;
+        }
+        else
+        {
+            frame.epochTime = 0U;
+            frame.multipleMessage = false;
+            frame.satellites = 0U;
+        }
+
+        return Result::Frame;
+    }
+}
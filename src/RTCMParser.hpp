@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief An incremental parser of RTCM 3 frames, fed one byte at a time.
+    class RTCMParser
+    {
+    public:
+        /// @brief The preamble of every RTCM 3 frame.
+        static constexpr uint8_t Preamble = 0xD3;
+
+        /// @brief The size of the frame header (preamble and length).
+        static constexpr uint8_t HeaderSize = 3U;
+
+        /// @brief The size of the CRC at the end of a frame.
+        static constexpr uint8_t CrcSize = 3U;
+
+        /// @brief The maximum size of the payload of a frame.
+        static constexpr uint16_t MaxPayloadSize = 1023U;
+
+        /// @brief The number of payload bytes kept to decode the message header, up to and
+        ///  including the satellite mask of an MSM.
+        static constexpr uint8_t MessageHeaderSize = 18U;
+
+        /// @brief The result of pushing a byte.
+        enum class Result : uint8_t
+        {
+            Skipped = 0,
+            Pending = 1,
+            Frame = 2,
+            Invalid = 3,
+        };
+
+        /// @brief The information of the last complete frame.
+        struct Frame
+        {
+        public:
+            uint16_t messageNumber;
+            uint16_t size;
+            uint32_t crc;
+            uint32_t epochTime;
+            uint8_t satellites;
+            bool msm;
+            bool multipleMessage;
+        };
+
+        /// @brief The state of the parser.
+        enum class State : uint8_t
+        {
+            Preamble = 0,
+            Length = 1,
+            Payload = 2,
+            Crc = 3,
+        };
+
+    public:
+        /// @brief Updates the CRC-24Q with the given byte.
+        /// @param crc the current CRC.
+        /// @param byte the byte.
+        /// @return the new CRC.
+        static uint32_t updateCrc(uint32_t crc, uint8_t byte) noexcept;
+
+        /// @brief Checks whether the given message number is a multiple signal message (MSM).
+        /// @param messageNumber the message number.
+        /// @return true if it is an MSM.
+        static bool isMSM(uint16_t messageNumber) noexcept;
+
+        /// @brief The number of constellations with MSMs, up to NavIC (1131 to 1137).
+        static constexpr uint8_t MSMConstellationCount = 7U;
+
+        /// @brief Gets the constellation of the given MSM, in the order of the message numbers.
+        /// @param messageNumber the message number of the MSM.
+        /// @return 0 for GPS, 1 for GLONASS, 2 for Galileo, 3 for SBAS, 4 for QZSS and 5 for BeiDou.
+        static inline uint8_t getMSMConstellation(uint16_t messageNumber) noexcept
+        {
+            return static_cast<uint8_t>((messageNumber - 1071U) / 10U);
+        }
+
+    private:
+        Frame frame_;
+        uint8_t messageHeader_[MessageHeaderSize];
+        uint32_t crc_;
+        uint32_t receivedCrc_;
+        uint16_t payloadSize_;
+        uint16_t received_;
+        State state_;
+
+    public:
+        /// @brief Constructs a new parser waiting for a preamble.
+        RTCMParser(void) noexcept;
+
+    public:
+        /// @brief Gets the information of the last complete frame.
+        /// @return the frame.
+        inline const Frame &getFrame(void) const noexcept
+        {
+            return this->frame_;
+        }
+
+        /// @brief Gets the number of bytes received of the current frame.
+        /// @return the number of bytes, including the preamble.
+        inline uint16_t getReceived(void) const noexcept
+        {
+            return this->received_;
+        }
+
+        /// @brief Discards the current frame and waits for the next preamble.
+        void reset(void) noexcept;
+
+        /// @brief Pushes the next byte of the stream.
+        /// @param byte the byte.
+        /// @return Skipped if the byte is not part of a frame, Pending if the frame is incomplete,
+        ///  Frame if it completed a valid frame and Invalid if it completed a corrupted frame.
+        Result push(uint8_t byte) noexcept;
+    };
+}
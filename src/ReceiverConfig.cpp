@@ -0,0 +1,196 @@
+#include <EEPROM.h>
+#include "config.hpp"
+#include "ReceiverConfig.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The compiled in table, written to the EEPROM when its version changes.
+    static const ReceiverConfig::Entry s_DefaultEntries[] PROGMEM = {
+        // The I2C output, NMEA would only wake us up for nothing.
+        {UBLOX_CFG_I2COUTPROT_UBX, 1U, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_I2COUTPROT_NMEA, 0U, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_I2COUTPROT_RTCM3X, 1U, ReceiverConfig::Stage::Output},
+#if LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED
+        // Active high, raised once the threshold (in units of 8 bytes) is pending on I2C.
+        {UBLOX_CFG_TXREADY_ENABLED, 1U, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_TXREADY_POLARITY, 0U, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_TXREADY_PIN, LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_RECEIVER_PIO, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_TXREADY_THRESHOLD, LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_THRESHOLD, ReceiverConfig::Stage::Output},
+        {UBLOX_CFG_TXREADY_INTERFACE, 0U, ReceiverConfig::Stage::Output},
+#endif
+        // The survey-in, only started when the receiver is not surveying already.
+        {UBLOX_CFG_TMODE_MODE, 1U, ReceiverConfig::Stage::Survey},
+        {UBLOX_CFG_TMODE_SVIN_MIN_DUR, LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_MIN_DURATION, ReceiverConfig::Stage::Survey},
+        {UBLOX_CFG_TMODE_SVIN_ACC_LIMIT, LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_ACCURACY_LIMIT, ReceiverConfig::Stage::Survey},
+        // The RTCM messages, enabled once the survey is valid.
+        {UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1005_I2C, 1U, ReceiverConfig::Stage::Stream},
+        {UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1077_I2C, 1U, ReceiverConfig::Stage::Stream},
+        {UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1087_I2C, 1U, ReceiverConfig::Stage::Stream},
+        {UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1230_I2C, 10U, ReceiverConfig::Stage::Stream},
+    };
+
+    /// @brief The number of compiled in entries.
+    static constexpr uint8_t s_DefaultEntryCount = sizeof(s_DefaultEntries) / sizeof(s_DefaultEntries[0]);
+
+    static_assert(s_DefaultEntryCount <= ReceiverConfig::MaxEntries,
+                  "The default receiver configuration has too many entries");
+
+    /// @brief Adds the given byte to a Fletcher-16 checksum.
+    /// @param sum1 the first sum.
+    /// @param sum2 the second sum.
+    /// @param byte the byte.
+    static inline void updateFletcher(uint16_t &sum1, uint16_t &sum2, uint8_t byte) noexcept
+    {
+        sum1 = (sum1 + byte) % 255U;
+        sum2 = (sum2 + sum1) % 255U;
+    }
+
+    /// @brief Constructs a new receiver configuration.
+    /// @param address the address of the table in the EEPROM.
+    ReceiverConfig::ReceiverConfig(int address) noexcept
+        : address_(address),
+          entryCount_(0U)
+    {
+    }
+
+    /// @brief Reads the given entry from the EEPROM.
+    /// @param index the index of the entry.
+    /// @return the entry.
+    ReceiverConfig::Entry ReceiverConfig::getEntry(uint8_t index) const noexcept
+    {
+        Entry entry;
+
+        EEPROM.get(this->address_ + static_cast<int>(sizeof(Header)) + index * static_cast<int>(sizeof(Entry)), entry);
+
+        return entry;
+    }
+
+    /// @brief Checks the table in the EEPROM, and writes the defaults if it is missing,
+    ///  corrupt or has another version.
+    /// @return true if the defaults were written.
+    bool ReceiverConfig::load(void) noexcept
+    {
+        Header header;
+
+        EEPROM.get(this->address_, header);
+
+        // Keeps the stored table if it is intact and has the version we were built with.
+        if (header.magic == Magic &&
+            header.version == LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION &&
+            header.entryCount <= MaxEntries &&
+            header.checksum == this->computeChecksum(header.entryCount))
+        {
+            this->entryCount_ = header.entryCount;
+            return false;
+        }
+
+        this->writeDefaults();
+        return true;
+    }
+
+    /// @brief Sends the entries of the given stages to the receiver in a single VALSET.
+    /// @param peripheral the receiver.
+    /// @param stageMask the stages to apply.
+    /// @return false if the VALSET did not fit or was not acknowledged.
+    bool ReceiverConfig::apply(SFE_UBLOX_GNSS &peripheral, uint8_t stageMask) const noexcept
+    {
+        uint8_t keyCount = 0U;
+
+        peripheral.newCfgValset(VAL_LAYER_RAM);
+
+        for (uint8_t i = 0U; i < this->entryCount_; ++i)
+        {
+            const Entry entry = this->getEntry(i);
+
+            if ((stageBit(entry.stage) & stageMask) == 0U)
+                continue;
+
+            // The size of the value is taken from the key.
+            if (!peripheral.addCfgValset(entry.key, entry.value))
+                return false;
+
+            ++keyCount;
+        }
+
+        // Nothing to send, an empty VALSET is not acknowledged.
+        if (keyCount == 0U)
+            return true;
+
+        return peripheral.sendCfgValset();
+    }
+
+    /// @brief Computes the checksum of the table in the EEPROM.
+    /// @param entryCount the number of entries to cover.
+    /// @return the Fletcher-16 checksum of the version, the entry count and the entries.
+    uint16_t ReceiverConfig::computeChecksum(uint8_t entryCount) const noexcept
+    {
+        const int entriesAddress = this->address_ + static_cast<int>(sizeof(Header));
+        const int entriesSize = entryCount * static_cast<int>(sizeof(Entry));
+        uint16_t sum1 = 0U, sum2 = 0U;
+
+        updateFletcher(sum1, sum2, LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION);
+        updateFletcher(sum1, sum2, entryCount);
+
+        for (int i = 0; i < entriesSize; ++i)
+            updateFletcher(sum1, sum2, EEPROM.read(entriesAddress + i));
+
+        return static_cast<uint16_t>((sum2 << 8) | sum1);
+    }
+
+    /// @brief Writes the compiled in defaults to the EEPROM.
+    void ReceiverConfig::writeDefaults(void) noexcept
+    {
+        int address = this->address_ + static_cast<int>(sizeof(Header));
+        uint16_t sum1 = 0U, sum2 = 0U;
+        Header header;
+
+        updateFletcher(sum1, sum2, LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION);
+        updateFletcher(sum1, sum2, s_DefaultEntryCount);
+
+#if defined(ARDUINO_ARCH_STM32)
+        // The EEPROM is emulated in flash, so the writes are collected in the buffer and the
+        //  page is erased once, instead of once for every byte.
+        eeprom_buffer_fill();
+#endif
+
+        // Copies the entries out of the flash, only the bytes that changed are written.
+        for (uint8_t i = 0U; i < s_DefaultEntryCount; ++i)
+        {
+            Entry entry;
+            memcpy_P(&entry, &s_DefaultEntries[i], sizeof(Entry));
+
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&entry);
+            for (uint8_t j = 0U; j < sizeof(Entry); ++j, ++address)
+            {
+                updateFletcher(sum1, sum2, bytes[j]);
+#if defined(ARDUINO_ARCH_STM32)
+                eeprom_buffered_write_byte(address, bytes[j]);
+#else
+                EEPROM.update(address, bytes[j]);
+#endif
+            }
+        }
+
+        // Writes the header last, a table that was only partially written stays invalid.
+        header.magic = Magic;
+        header.version = LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION;
+        header.entryCount = s_DefaultEntryCount;
+        header.checksum = static_cast<uint16_t>((sum2 << 8) | sum1);
+
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&header);
+        for (uint8_t j = 0U; j < sizeof(Header); ++j)
+        {
+#if defined(ARDUINO_ARCH_STM32)
+            eeprom_buffered_write_byte(this->address_ + j, bytes[j]);
+#else
+            EEPROM.update(this->address_ + j, bytes[j]);
+#endif
+        }
+
+#if defined(ARDUINO_ARCH_STM32)
+        eeprom_buffer_flush();
+#endif
+
+        this->entryCount_ = s_DefaultEntryCount;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The configuration of the receiver as a table of configuration keys and values,
+    ///  stored with a version and checksum in the EEPROM.
+    ///
+    /// Every entry belongs to a stage, the entries of the requested stages are sent together
+    ///  in a single UBX-CFG-VALSET, so a stage costs one round trip instead of one per setting.
+    ///  The table is written to the RAM layer only, the receiver gets it again on every start.
+    class ReceiverConfig
+    {
+    public:
+        /// @brief The stage of the startup an entry is applied in.
+        enum class Stage : uint8_t
+        {
+            Output = 0,
+            Survey = 1,
+            Stream = 2,
+        };
+
+        /// @brief A single configuration key and its value.
+        struct Entry
+        {
+        public:
+            uint32_t key;
+            uint32_t value;
+            Stage stage;
+        };
+
+        /// @brief The header in front of the entries in the EEPROM.
+        struct Header
+        {
+        public:
+            uint16_t magic;
+            uint8_t version;
+            uint8_t entryCount;
+            uint16_t checksum;
+        };
+
+        /// @brief The magic number that marks a stored table.
+        static constexpr uint16_t Magic = 0x5243U;
+
+        /// @brief The maximum number of entries, a VALSET holds at most 64 keys.
+        static constexpr uint8_t MaxEntries = 32U;
+
+        /// @brief Gets the bit of the given stage in a stage mask.
+        /// @param stage the stage.
+        /// @return the bit of the stage.
+        static inline uint8_t stageBit(Stage stage) noexcept
+        {
+            return static_cast<uint8_t>(1U << static_cast<uint8_t>(stage));
+        }
+
+    private:
+        const int address_;
+        uint8_t entryCount_;
+
+    public:
+        /// @brief Constructs a new receiver configuration.
+        /// @param address the address of the table in the EEPROM.
+        ReceiverConfig(int address) noexcept;
+
+    public:
+        /// @brief Gets the number of entries in the table.
+        /// @return the number of entries.
+        inline uint8_t getEntryCount(void) const noexcept
+        {
+            return this->entryCount_;
+        }
+
+        /// @brief Reads the given entry from the EEPROM.
+        /// @param index the index of the entry.
+        /// @return the entry.
+        Entry getEntry(uint8_t index) const noexcept;
+
+        /// @brief Checks the table in the EEPROM, and writes the defaults if it is missing,
+        ///  corrupt or has another version.
+        /// @return true if the defaults were written.
+        bool load(void) noexcept;
+
+        /// @brief Sends the entries of the given stages to the receiver in a single VALSET.
+        /// @param peripheral the receiver.
+        /// @param stageMask the stages to apply.
+        /// @return false if the VALSET did not fit or was not acknowledged.
+        bool apply(SFE_UBLOX_GNSS &peripheral, uint8_t stageMask) const noexcept;
+
+    private:
+        /// @brief Computes the checksum of the table in the EEPROM.
+        /// @param entryCount the number of entries to cover.
+        /// @return the Fletcher-16 checksum of the version, the entry count and the entries.
+        uint16_t computeChecksum(uint8_t entryCount) const noexcept;
+
+        /// @brief Writes the compiled in defaults to the EEPROM.
+        void writeDefaults(void) noexcept;
+    };
+}
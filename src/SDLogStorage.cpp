@@ -0,0 +1,63 @@
+#include "SDLogStorage.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new SD card storage.
+    /// @param csPin the chip select pin of the card.
+    SDLogStorage::SDLogStorage(uint8_t csPin) noexcept
+        : csPin_(csPin),
+          file_()
+    {
+    }
+
+    /// @brief Begins the card, and mounts its file system.
+    bool SDLogStorage::begin(void) noexcept
+    {
+        return SD.begin(this->csPin_);
+    }
+
+    /// @brief Checks whether a file with the given name exists.
+    bool SDLogStorage::exists(const char *name) noexcept
+    {
+        return SD.exists(name);
+    }
+
+    /// @brief Creates the given file, or opens it for appending if it exists, as the log file.
+    bool SDLogStorage::open(const char *name) noexcept
+    {
+        this->file_ = SD.open(name, FILE_WRITE);
+        return static_cast<bool>(this->file_);
+    }
+
+    /// @brief Appends the given data to the log file.
+    bool SDLogStorage::write(const uint8_t *data, uint16_t size) noexcept
+    {
+        return this->file_.write(data, size) == size;
+    }
+
+    /// @brief Commits the written data and the size of the log file to the card.
+    bool SDLogStorage::sync(void) noexcept
+    {
+        this->file_.flush();
+        return true;
+    }
+
+    /// @brief Closes the log file.
+    void SDLogStorage::close(void) noexcept
+    {
+        this->file_.close();
+    }
+
+    /// @brief Appends the given data to another file, opening and closing it again.
+    bool SDLogStorage::append(const char *name, const uint8_t *data, uint16_t size) noexcept
+    {
+        File file = SD.open(name, FILE_WRITE);
+        if (!file)
+            return false;
+
+        const bool written = file.write(data, size) == size;
+        file.close();
+
+        return written;
+    }
+}
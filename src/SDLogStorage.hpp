@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+#include "RTCMLogStorage.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief The RTCM log storage on an SD card, sharing the SPI bus with the radio.
+    class SDLogStorage : public RTCMLogStorage
+    {
+    private:
+        const uint8_t csPin_;
+        File file_;
+
+    public:
+        /// @brief Constructs a new SD card storage.
+        /// @param csPin the chip select pin of the card.
+        SDLogStorage(uint8_t csPin) noexcept;
+
+    public:
+        bool begin(void) noexcept override;
+        bool exists(const char *name) noexcept override;
+        bool open(const char *name) noexcept override;
+        bool write(const uint8_t *data, uint16_t size) noexcept override;
+        bool sync(void) noexcept override;
+        void close(void) noexcept override;
+        bool append(const char *name, const uint8_t *data, uint16_t size) noexcept override;
+    };
+}
@@ -0,0 +1,59 @@
+#include "SequenceWindow.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs an empty sequence window.
+    SequenceWindow::SequenceWindow(void) noexcept
+        : seen_(0U),
+          highest_(0U),
+          started_(false)
+    {
+    }
+
+    /// @brief Forgets all the seen sequence numbers.
+    void SequenceWindow::reset(void) noexcept
+    {
+        this->seen_ = 0U;
+        this->highest_ = 0U;
+        this->started_ = false;
+    }
+
+    /// @brief Marks the given sequence number as seen.
+    /// @param sequence the sequence number.
+    /// @return false if it was seen before, or is too old to tell.
+    bool SequenceWindow::accept(uint16_t sequence) noexcept
+    {
+        const uint16_t ahead = sequence - this->highest_;
+        const uint16_t behind = this->highest_ - sequence;
+
+        // Starts over at the first sequence number, or when the source restarted.
+        if (!this->started_ || (behind > RestartDistance && behind < 0x8000U))
+        {
+            this->seen_ = 1U;
+            this->highest_ = sequence;
+            this->started_ = true;
+            return true;
+        }
+
+        // Slides the window forward if the sequence number is newer than the highest.
+        if (ahead != 0U && ahead < 0x8000U)
+        {
+            this->seen_ = ahead >= Size ? 0U : this->seen_ << ahead;
+            this->seen_ |= 1U;
+            this->highest_ = sequence;
+            return true;
+        }
+
+        // Rejects the sequence numbers that fell out of the window.
+        if (behind >= Size)
+            return false;
+
+        // Rejects the sequence number if it has been seen, and marks it otherwise.
+        const uint32_t bit = static_cast<uint32_t>(1U) << behind;
+        if ((this->seen_ & bit) != 0U)
+            return false;
+
+        this->seen_ |= bit;
+        return true;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief A sliding window over 16-bit sequence numbers, used to suppress duplicates.
+    class SequenceWindow
+    {
+    public:
+        /// @brief The number of sequence numbers behind the highest one that are remembered.
+        static constexpr uint8_t Size = 32U;
+
+        /// @brief A jump backwards larger than this is taken as a restart of the source.
+        static constexpr uint16_t RestartDistance = 1024U;
+
+    private:
+        uint32_t seen_;
+        uint16_t highest_;
+        bool started_;
+
+    public:
+        /// @brief Constructs an empty sequence window.
+        SequenceWindow(void) noexcept;
+
+    public:
+        /// @brief Forgets all the seen sequence numbers.
+        void reset(void) noexcept;
+
+        /// @brief Marks the given sequence number as seen.
+        /// @param sequence the sequence number.
+        /// @return false if it was seen before, or is too old to tell.
+        bool accept(uint16_t sequence) noexcept;
+    };
+}
@@ -0,0 +1,113 @@
+#include <Arduino.h>
+#include "UBXRequests.hpp"
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Constructs a new request engine.
+    /// @param requests the storage of the requests.
+    /// @param maxRequests the number of requests that fit in the storage.
+    UBXRequests::UBXRequests(Request *requests, uint8_t maxRequests) noexcept
+        : requests_(requests),
+          maxRequests_(maxRequests),
+          requestCount_(0U)
+    {
+    }
+
+    /// @brief Registers the given request.
+    /// @param name the name of the request.
+    /// @param sendCallback the callback that sends the poll.
+    /// @param receivedCallback the callback that checks for the response.
+    /// @param completeCallback the callback that handles the completion.
+    /// @param timeout the time to wait for the response.
+    /// @param userData the user data passed to the callbacks.
+    /// @return the handle of the request, or NoRequest if there is no room for it.
+    UBXRequests::Handle UBXRequests::add(const char *name, SendCallback sendCallback, ReceivedCallback receivedCallback,
+                                         CompleteCallback completeCallback, uint16_t timeout, void *userData) noexcept
+    {
+        // Makes sure there is room for the request.
+        if (this->requestCount_ >= this->maxRequests_)
+            return NoRequest;
+
+        // Stores the request.
+        Request &request = this->requests_[this->requestCount_];
+        request.name = name;
+        request.sendCallback = sendCallback;
+        request.receivedCallback = receivedCallback;
+        request.completeCallback = completeCallback;
+        request.userData = userData;
+        request.issuedMillis = 0U;
+        request.timeout = timeout;
+        request.pending = false;
+        request.issued = 0U;
+        request.completed = 0U;
+        request.timedOut = 0U;
+        request.totalLatencyMillis = 0U;
+        request.maxLatencyMillis = 0U;
+
+        return this->requestCount_++;
+    }
+
+    /// @brief Sends the poll of the given request.
+    /// @param handle the handle of the request.
+    /// @return false if the request is still pending.
+    bool UBXRequests::issue(Handle handle) noexcept
+    {
+        Request &request = this->requests_[handle];
+
+        if (request.pending)
+            return false;
+
+        // Drops a stale response, so it does not complete the new poll.
+        request.receivedCallback(request.userData);
+
+        request.sendCallback(request.userData);
+        request.issuedMillis = millis();
+        request.pending = true;
+        ++request.issued;
+
+        return true;
+    }
+
+    /// @brief Forgets the outstanding polls, their responses are no longer wanted.
+    void UBXRequests::cancel(void) noexcept
+    {
+        for (uint8_t i = 0U; i < this->requestCount_; ++i)
+            this->requests_[i].pending = false;
+    }
+
+    /// @brief Completes the requests that received their response or timed out, the
+    ///  driver must have read the pending data before.
+    void UBXRequests::loop(void) noexcept
+    {
+        const uint32_t currentMillis = millis();
+
+        for (uint8_t i = 0U; i < this->requestCount_; ++i)
+        {
+            Request &request = this->requests_[i];
+
+            if (!request.pending)
+                continue;
+
+            const uint32_t latencyMillis = currentMillis - request.issuedMillis;
+
+            if (request.receivedCallback(request.userData))
+            {
+                ++request.completed;
+                request.totalLatencyMillis += latencyMillis;
+                if (latencyMillis > request.maxLatencyMillis)
+                    request.maxLatencyMillis = latencyMillis;
+
+                // Not pending anymore before the callback, it may issue the request again.
+                request.pending = false;
+                request.completeCallback(request.userData, true);
+            }
+            else if (latencyMillis >= request.timeout)
+            {
+                ++request.timedOut;
+
+                request.pending = false;
+                request.completeCallback(request.userData, false);
+            }
+        }
+    }
+}
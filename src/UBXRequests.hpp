@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace lacar::droid_basestation::firmware
+{
+    /// @brief Issues UBX polls without waiting for their responses, and completes them from
+    ///  the loop once the response has arrived or the request has timed out.
+    ///
+    /// The driver stores a response when it reads it in checkUblox, every request has a
+    ///  callback that sends the poll and one that checks (and consumes) the stored response.
+    ///  A request has at most one poll outstanding, issuing it again while it is pending fails.
+    class UBXRequests
+    {
+    public:
+        /// @brief Called to send the poll, without waiting for the response.
+        typedef void (*SendCallback)(void *);
+
+        /// @brief Called to check whether the response has been stored, and consumes it.
+        typedef bool (*ReceivedCallback)(void *);
+
+        /// @brief Called when the request completed, or with false when it timed out.
+        typedef void (*CompleteCallback)(void *, bool);
+
+        /// @brief The index of a request.
+        typedef uint8_t Handle;
+
+        /// @brief The handle that refers to no request.
+        static constexpr Handle NoRequest = 0xFFU;
+
+        /// @brief A single registered request and its statistics.
+        struct Request
+        {
+        public:
+            const char *name;
+            SendCallback sendCallback;
+            ReceivedCallback receivedCallback;
+            CompleteCallback completeCallback;
+            void *userData;
+            uint32_t issuedMillis;
+            uint16_t timeout;
+            bool pending;
+            uint32_t issued;
+            uint32_t completed;
+            uint32_t timedOut;
+            uint32_t totalLatencyMillis;
+            uint32_t maxLatencyMillis;
+        };
+
+    private:
+        Request *const requests_;
+        const uint8_t maxRequests_;
+        uint8_t requestCount_;
+
+    public:
+        /// @brief Constructs a new request engine.
+        /// @param requests the storage of the requests.
+        /// @param maxRequests the number of requests that fit in the storage.
+        UBXRequests(Request *requests, uint8_t maxRequests) noexcept;
+
+    public:
+        /// @brief Gets the number of registered requests.
+        /// @return the number of requests.
+        inline uint8_t getRequestCount(void) const noexcept
+        {
+            return this->requestCount_;
+        }
+
+        /// @brief Gets the request with the given handle.
+        /// @param handle the handle of the request.
+        /// @return the request.
+        inline const Request &getRequest(Handle handle) const noexcept
+        {
+            return this->requests_[handle];
+        }
+
+        /// @brief Gets whether the given request is waiting for its response.
+        /// @param handle the handle of the request.
+        /// @return true if it is pending.
+        inline bool isPending(Handle handle) const noexcept
+        {
+            return this->requests_[handle].pending;
+        }
+
+        /// @brief Registers the given request.
+        /// @param name the name of the request.
+        /// @param sendCallback the callback that sends the poll.
+        /// @param receivedCallback the callback that checks for the response.
+        /// @param completeCallback the callback that handles the completion.
+        /// @param timeout the time to wait for the response.
+        /// @param userData the user data passed to the callbacks.
+        /// @return the handle of the request, or NoRequest if there is no room for it.
+        Handle add(const char *name, SendCallback sendCallback, ReceivedCallback receivedCallback,
+                   CompleteCallback completeCallback, uint16_t timeout, void *userData) noexcept;
+
+        /// @brief Sends the poll of the given request.
+        /// @param handle the handle of the request.
+        /// @return false if the request is still pending.
+        bool issue(Handle handle) noexcept;
+
+        /// @brief Forgets the outstanding polls, their responses are no longer wanted.
+        void cancel(void) noexcept;
+
+        /// @brief Completes the requests that received their response or timed out, the
+        ///  driver must have read the pending data before.
+        void loop(void) noexcept;
+    };
+}
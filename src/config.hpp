@@ -2,15 +2,145 @@
 
 #include <Arduino.h>
 
+// The settings that depend on the board, the STM32 build has the room for larger buffers.
+#if defined(ARDUINO_ARCH_STM32)
 #define LACAR_DROID_BASESTATION_FIRMWARE__SPI1__SCK PA5
 #define LACAR_DROID_BASESTATION_FIRMWARE__SPI1__MISO PA6
 #define LACAR_DROID_BASESTATION_FIRMWARE__SPI1__MOSI PA7
 
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__CE PB0
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__CS PA4
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__EPOCH_BUFFER_SIZE 4096
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS 192
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__I2C_TRANSACTION_SIZE 128
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TIMEPULSE_PIN PB1
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_PIN PB2
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE 16
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__TIMEOUT 8000000UL
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SD_CS PB12
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__BLOCK_COUNT 16
+#else
 #define LACAR_DROID_BASESTATION_FIRMWARE__RF24__CE 6
 #define LACAR_DROID_BASESTATION_FIRMWARE__RF24__CS 5
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__EPOCH_BUFFER_SIZE 768
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__FRAME_POOL_BLOCKS 48
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__I2C_TRANSACTION_SIZE 32
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TIMEPULSE_PIN 2
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_PIN 3
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_CACHE_SIZE 8
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__TIMEOUT WDTO_8S
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SD_CS 53
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__BLOCK_COUNT 3
+#endif
+
+// Offsets the correction slots by ID * TDMA__STATION_SLOT_STRIDE, 0 to 2 with the default slots.
+#define LACAR_DROID_BASESTATION_FIRMWARE__STATION__ID 0
+
 #define LACAR_DROID_BASESTATION_FIRMWARE__RF24__ADDR 0
 #define LACAR_DROID_BASESTATION_FIRMWARE__RF24__DATA_RATE RF24_250KBPS 
 #define LACAR_DROID_BASESTATION_FIRMWARE__RF24__CHANNEL 90
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_LEVEL 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_RETRIES 3
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_RETRY_DELAY 100
+#define LACAR_DROID_BASESTATION_FIRMWARE__RF24__MULTICAST_MAX_CONSECUTIVE_DROPS 8
 
 #define LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_SIZE 32
-#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_FLUSH_AFTER 10
\ No newline at end of file
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__RTCM_BUFFER_FLUSH_AFTER 25
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_SINKS 4
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_ENABLED 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_RECEIVER_PIO 6
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_THRESHOLD 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_POLL_INTERVAL 250
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__TXREADY_POLLING_WAIT 5
+// Bump the version after changing the receiver configuration table, so the stored table is replaced.
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_VERSION 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__RECEIVER_CONFIG_ADDRESS 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_STATUS_INTERVAL 1000
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__REQUEST_TIMEOUT 2000
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__MAX_REQUESTS 2
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_MIN_DURATION 300
+// In units of 0.1 mm.
+#define LACAR_DROID_BASESTATION_FIRMWARE__GPS__SURVEY_ACCURACY_LIMIT 100000
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__QUEUE_SIZE 16
+#define LACAR_DROID_BASESTATION_FIRMWARE__EVENTS__MAX_SUBSCRIBERS 4
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__DISPLAY__UPDATE_INTERVAL 500
+#define LACAR_DROID_BASESTATION_FIRMWARE__DISPLAY__PAGE_INTERVAL 4000
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__THROUGHPUT_INTERVAL 1000
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_AGGREGATE 5
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__REPAIR_HOLDOFF 50
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_ENABLED 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_LAST_LEVEL 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__RELAY_MAX_SOURCES 4
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_BROADCAST 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__RAW_TX_TIMEOUT 20
+// Enable the channel survey on one station only, the others follow its announcements.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SURVEY_ENABLED 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_FIRST 70
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_LAST 125
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_STEP 5
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SETUP_SAMPLES 100
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_BURST_SAMPLES 10
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_WINDOW_SAMPLES 200
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SAMPLE_INTERVAL 100
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SURVEY_INTERVAL 60000
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_SWITCH_MARGIN 20
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_ANNOUNCE_COUNT 5
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_ANNOUNCE_INTERVAL 1000
+// The time in RX before the received power detector is read, at least 170 us.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__CHANNEL_DWELL 200
+// Ends every epoch with a tag the rovers check before using it, see lib/DroidRover.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_ENABLED 0
+// The 128-bit key of the tag as four words, shared with the rovers, replace it on every fleet.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__AUTH_KEY 0x5F3C2A91UL, 0xB4E8D706UL, 0x19A7C35EUL, 0x7D06F2B8UL
+// Sends unchanged 1005 and 1230 frames as a marker, opt-in since only the rovers that use
+//  lib/DroidRover resolve it.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__STATIC_DEDUP_ENABLED 0
+// The interval at which they are sent in full anyway, for the rovers that just joined.
+#define LACAR_DROID_BASESTATION_FIRMWARE__COM__STATIC_REFRESH_INTERVAL 30000
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__MEMORY__CANARY 0xC5
+#define LACAR_DROID_BASESTATION_FIRMWARE__MEMORY__SCAN_INTERVAL 5000
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__INITIAL_DELAY 250
+#define LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_DELAY 30000
+#define LACAR_DROID_BASESTATION_FIRMWARE__RECOVERY__MAX_ATTEMPTS 10
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__ENABLED 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_COUNT 10
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__SLOT_LENGTH 100000UL
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__CORRECTION_SLOTS 0x0006U
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__UPLINK_SLOTS 0x0300U
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__PPS_TIMEOUT 3000000UL
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__STATION_SLOT_STRIDE 2
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__MAX_FOREIGN_STATIONS 3
+#define LACAR_DROID_BASESTATION_FIRMWARE__TDMA__FOREIGN_STATION_TIMEOUT 5000
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__CONSOLE__LINE_SIZE 48
+#define LACAR_DROID_BASESTATION_FIRMWARE__CONSOLE__MAX_COMMANDS 12
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__PROFILER__ENABLED 1
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__ENABLED 1
+#define LACAR_DROID_BASESTATION_FIRMWARE__WATCHDOG__MODULE_BUDGET 50000UL
+
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__ENABLED 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__MAX_FILE_SIZE 4194304UL
+#define LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__SYNC_AFTER 5000
+
+// Every queued epoch holds a full epoch of the frame pool, so enabling the serial output
+//  takes GPS__FRAME_POOL_BLOCKS up by QUEUE_SIZE epochs, see the assert in MyGPS.hpp.
+#define LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED 0
+#define LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__PORT Serial1
+#define LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__BAUD_RATE 115200
+#define LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__QUEUE_SIZE 4
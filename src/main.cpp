@@ -5,15 +5,38 @@
 #include "MyCom.hpp"
 #include "MyGPS.hpp"
 #include "MyDisplay.hpp"
+#include "MyEvents.hpp"
+#include "MyMemory.hpp"
+#include "MySchedule.hpp"
+#include "MyConsole.hpp"
+#include "MyProfiler.hpp"
+#include "MyWatchdog.hpp"
+#include "MyLogger.hpp"
+#include "MySerialOutput.hpp"
 
 using namespace lacar::droid_basestation::firmware;
 
 void setup() {
   Serial.begin(115200);
 
+#if defined(ARDUINO_ARCH_STM32)
+  // Routes the radio and the card to the pins of SPI1.
+  SPI.setSCLK(LACAR_DROID_BASESTATION_FIRMWARE__SPI1__SCK);
+  SPI.setMISO(LACAR_DROID_BASESTATION_FIRMWARE__SPI1__MISO);
+  SPI.setMOSI(LACAR_DROID_BASESTATION_FIRMWARE__SPI1__MOSI);
+#endif
+
   SPI.begin();
   Wire.begin();
 
+  MyConsole::getInstance().setup();
+
+  // Arms the watchdog before the other modules, so it covers their setup as well.
+  MyWatchdog::getInstance().setup();
+
+  MyProfiler::getInstance().setup();
+  MyEvents::getInstance().setup();
+  MySchedule::getInstance().setup();
   MyDisplay::getInstance().setup();
   MyCom::getInstance().setup();
   MyGPS::getInstance().setup();
@@ -23,10 +46,61 @@ void setup() {
 
   // Enables the com.
   MyCom::getInstance().enable();
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__ENABLED
+  MyLogger::getInstance().setup();
+#endif
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED
+  MySerialOutput::getInstance().setup();
+#endif
+
+  // Reports the RAM usage after everything has been set up.
+  MyMemory::getInstance().setup();
+
+  MyWatchdog::getInstance().finishSetup();
 }
 
 void loop() {
+  MyWatchdog &watchdog = MyWatchdog::getInstance();
+
+  // Times every module against the loop budget, and keeps track of the module we're in
+  //  for when the watchdog resets the board.
+  watchdog.enter(MyWatchdog::Module::Console, 0U);
+  MyConsole::getInstance().loop();
+  watchdog.leave();
+
+  watchdog.enter(MyWatchdog::Module::Events, 0U);
+  MyEvents::getInstance().loop();
+  watchdog.leave();
+
+  watchdog.enter(MyWatchdog::Module::Display, static_cast<uint8_t>(MyDisplay::getInstance().getState()));
   MyDisplay::getInstance().loop();
+  watchdog.leave();
+
+  watchdog.enter(MyWatchdog::Module::Com, static_cast<uint8_t>(MyCom::getInstance().getState()));
   MyCom::getInstance().loop();
+  watchdog.leave();
+
+  watchdog.enter(MyWatchdog::Module::GPS, static_cast<uint8_t>(MyGPS::getInstance().getState()));
   MyGPS::getInstance().loop();
+  watchdog.leave();
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__LOGGER__ENABLED
+  watchdog.enter(MyWatchdog::Module::Logger, 0U);
+  MyLogger::getInstance().loop();
+  watchdog.leave();
+#endif
+
+#if LACAR_DROID_BASESTATION_FIRMWARE__SERIAL_OUTPUT__ENABLED
+  watchdog.enter(MyWatchdog::Module::SerialOutput, 0U);
+  MySerialOutput::getInstance().loop();
+  watchdog.leave();
+#endif
+
+  watchdog.enter(MyWatchdog::Module::Memory, 0U);
+  MyMemory::getInstance().loop();
+  watchdog.leave();
+
+  watchdog.feed();
 }